@@ -0,0 +1,215 @@
+// Copyright 2024 Samuel Freeman All rights reserved.
+
+
+#include "Framework/LandscapeBakeCommandlet.h"
+#include "Framework/LandscapeCore.h"
+#include "Framework/LandscapeSectionData.h"
+#include "Framework/LandscapeChunkScheduler.h"
+#include "Framework/LandscapeBiomePointCache.h"
+#include "Framework/LandscapeSectionTopology.h"
+#include "Framework/LandscapeHeightfield.h"
+#include "Framework/LandscapeBakedArchive.h"
+#include "Framework/LandscapeFoliagePlacement.h"
+#include "Async/ParallelFor.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/Paths.h"
+#include "UObject/StrongObjectPtr.h"
+
+
+// One chunk at one pyramid level, Built on a worker and written on the game thread.
+struct FLandscapeBakeJob
+{
+    FIntPoint Chunk = FIntPoint::ZeroValue;
+    int32 Level = 0;
+
+    TStrongObjectPtr<URealtimeMeshSimple> RealtimeMesh;
+    TSharedPtr<LandscapeSectionData> LandscapeSection;
+
+    FLandscapeHeightfieldTile Tile;
+    TArray<float> BiomeWeights;
+    bool bSucceeded = false;
+};
+
+ULandscapeBakeCommandlet::ULandscapeBakeCommandlet()
+{
+    IsClient = false;
+    IsServer = false;
+    LogToConsole = true;
+}
+
+int32 ULandscapeBakeCommandlet::Main(const FString& Params)
+{
+    ALandscapeCore* Landscape = GetMutableDefault<ALandscapeCore>();
+    FString LandscapeName = TEXT("Default");
+    FString LandscapePath;
+    if (FParse::Value(*Params, TEXT("Landscape="), LandscapePath))
+    {
+        UClass* LandscapeClass = LoadClass<ALandscapeCore>(nullptr, *LandscapePath);
+        if (!LandscapeClass)
+        {
+            UE_LOG(LogTemp, Error, TEXT("Landscape Bake : Could not load landscape class %s"), *LandscapePath);
+            return 1;
+        }
+        Landscape = LandscapeClass->GetDefaultObject<ALandscapeCore>();
+        LandscapeName = LandscapeClass->GetName();
+    }
+
+    FIntPoint ChunkMin(-16, -16);
+    FIntPoint ChunkMax(15, 15);
+    FParse::Value(*Params, TEXT("MinX="), ChunkMin.X);
+    FParse::Value(*Params, TEXT("MinY="), ChunkMin.Y);
+    FParse::Value(*Params, TEXT("MaxX="), ChunkMax.X);
+    FParse::Value(*Params, TEXT("MaxY="), ChunkMax.Y);
+    if (ChunkMax.X < ChunkMin.X || ChunkMax.Y < ChunkMin.Y)
+    {
+        UE_LOG(LogTemp, Error, TEXT("Landscape Bake : Empty chunk range (%d, %d) - (%d, %d)"), ChunkMin.X, ChunkMin.Y, ChunkMax.X, ChunkMax.Y);
+        return 1;
+    }
+
+    int32 BatchSize = 4 * FPlatformMisc::NumberOfCoresIncludingHyperthreads();
+    FParse::Value(*Params, TEXT("BatchSize="), BatchSize);
+    BatchSize = FMath::Max(BatchSize, 1);
+
+    FString OutputPath = FPaths::ProjectContentDir() / TEXT("TerrainBake") / LandscapeName + TEXT(".ltb");
+    FParse::Value(*Params, TEXT("Output="), OutputPath);
+
+    // Normalizes the Lod depths and computes the signature the runtime checks the archive against.
+    Landscape->SetCurrentParams();
+
+    // Pyramid levels finest first, Every resolution the landscape can ask a section for.
+    TArray<int32> Resolutions;
+    if (Landscape->bUseLODs && !Landscape->LodDepths.IsEmpty())
+    {
+        for (const auto& LodDepth : Landscape->LodDepths)
+        {
+            Resolutions.AddUnique(LodDepth.LODResolution);
+        }
+    }
+    else
+    {
+        Resolutions.Add(FMath::Max(Landscape->SubDivitions, 4));
+    }
+    Resolutions.Sort(TGreater<int32>());
+
+    float SectionScale = Landscape->SectionScale;
+    int32 NumBiomes = Landscape->LandscapeNoiseParams.BiomeGenerationData.Biomes.Num();
+
+    TSharedPtr<ScatteredBiomeBlender> BiomeBlender = MakeShared<ScatteredBiomeBlender>();
+    BiomeBlender->Initialize(Landscape->LandscapeNoiseParams.BiomeGenerationData.PointFrequency, Landscape->LandscapeNoiseParams.BiomeGenerationData.BlendRadiusPadding, SectionScale);
+
+    TSharedPtr<FLandscapeBiomePointCache, ESPMode::ThreadSafe> BiomePointCache = MakeShared<FLandscapeBiomePointCache, ESPMode::ThreadSafe>(
+        BiomeBlender->GetBlendRadius(),
+        SectionScale,
+        NumBiomes,
+        [Blender = BiomeBlender](const FVector2D& InMin, const FVector2D& InMax, TArray<FVector2D>& OutLocations)
+        {
+            Blender->GatherPoints(InMin, InMax, OutLocations);
+        },
+        [NoiseParams = Landscape->LandscapeNoiseParams](double InX, double InY)
+        {
+            return NoiseParams.GetBiomeIndexAt(InX, InY);
+        });
+
+    TArray<FLandscapeSectionTopologyPtr> Topologies;
+    for (int32 Resolution : Resolutions)
+    {
+        Topologies.Add(MakeShared<const FLandscapeSectionTopology, ESPMode::ThreadSafe>(Resolution, Landscape->UVScale));
+    }
+
+    FLandscapeHeightQuantization HeightQuantization = Landscape->GetHeightQuantization();
+
+    FLandscapeBakedArchiveWriter ArchiveWriter(OutputPath, Landscape->ChunkCacheSignature, ChunkMin, ChunkMax, Resolutions, NumBiomes);
+    if (!ArchiveWriter.IsValid())
+    {
+        UE_LOG(LogTemp, Error, TEXT("Landscape Bake : Could not open %s for writing"), *OutputPath);
+        return 1;
+    }
+
+    int32 ChunksWide = ChunkMax.X - ChunkMin.X + 1;
+    int64 NumJobs = int64(ChunksWide) * (ChunkMax.Y - ChunkMin.Y + 1) * Resolutions.Num();
+    int64 NumFailed = 0;
+    double StartTime = FPlatformTime::Seconds();
+
+    UE_LOG(LogTemp, Display, TEXT("Landscape Bake : Baking %s, chunks (%d, %d) - (%d, %d) at %d resolution(s) into %s"),
+        *LandscapeName, ChunkMin.X, ChunkMin.Y, ChunkMax.X, ChunkMax.Y, Resolutions.Num(), *OutputPath);
+
+    for (int64 FirstJob = 0; FirstJob < NumJobs; FirstJob += BatchSize)
+    {
+        // Meshes and section data are UObject backed so they are created here on the game thread, Only generation runs in parallel.
+        TArray<FLandscapeBakeJob> Jobs;
+        Jobs.SetNum(int32(FMath::Min<int64>(BatchSize, NumJobs - FirstJob)));
+
+        for (int32 i = 0; i < Jobs.Num(); i++)
+        {
+            FLandscapeBakeJob& Job = Jobs[i];
+            int64 JobIndex = FirstJob + i;
+            int64 ChunkIndex = JobIndex / Resolutions.Num();
+            Job.Level = int32(JobIndex % Resolutions.Num());
+            Job.Chunk = FIntPoint(ChunkMin.X + int32(ChunkIndex % ChunksWide), ChunkMin.Y + int32(ChunkIndex / ChunksWide));
+
+            int32 Resolution = Resolutions[Job.Level];
+            Job.RealtimeMesh = TStrongObjectPtr<URealtimeMeshSimple>(NewObject<URealtimeMeshSimple>(GetTransientPackage(), NAME_None, RF_Transient));
+            Job.LandscapeSection = MakeShared<LandscapeSectionData>(Job.RealtimeMesh.Get(), Landscape->StreamSet, Landscape->LandscapeNoiseParams, FChunkParams(
+                nullptr,
+                SectionScale,
+                Resolution,
+                SectionScale / Resolution,
+                Landscape->UVScale,
+                float(SectionScale * Job.Chunk.X),
+                float(SectionScale * Job.Chunk.Y)),
+                BiomeBlender,
+                FVector::ZeroVector,
+                nullptr,
+                Landscape->WorldXOffset,
+                Landscape->WorldYOffset);
+
+            Job.LandscapeSection->SetCancellationToken(MakeShared<FSectionJobToken, ESPMode::ThreadSafe>(uint32(JobIndex + 1), false));
+            Job.LandscapeSection->SetBiomePointCache(BiomePointCache);
+            Job.LandscapeSection->SetSharedTopology(Topologies[Job.Level]);
+            Job.LandscapeSection->SetCreateCollision(false);
+        }
+
+        ParallelFor(Jobs.Num(), [&](int32 JobIndex)
+            {
+                FLandscapeBakeJob& Job = Jobs[JobIndex];
+                int32 Resolution = Resolutions[Job.Level];
+
+                Job.LandscapeSection->CreateChunk();
+                Job.RealtimeMesh->ProcessMesh(Landscape->GetSectionGroupKey(FChunkLocation(Job.Chunk.X, Job.Chunk.Y)), [&](const FRealtimeMeshStreamSet& Streams)
+                    {
+                        Job.bSucceeded = Job.Tile.ReadFromStreams(Streams, Resolution, HeightQuantization, Topologies[Job.Level].Get());
+                    });
+
+                // Weights on the tiles own grid, where the runtime foliage placement samples them.
+                if (Job.bSucceeded && NumBiomes > 0)
+                {
+                    FVector2D GridOrigin(double(SectionScale) * Job.Chunk.X + Landscape->WorldXOffset + Job.Tile.Origin.X, double(SectionScale) * Job.Chunk.Y + Landscape->WorldYOffset + Job.Tile.Origin.Y);
+                    BiomePointCache->ComputeTileWeights(GridOrigin, Job.Tile.GetStep(), Job.Tile.GetVerticesPerSide(), Job.Tile.GetVerticesPerSide(), Job.BiomeWeights);
+                }
+            });
+
+        for (FLandscapeBakeJob& Job : Jobs)
+        {
+            if (!Job.bSucceeded || !ArchiveWriter.AddTile(Job.Chunk, Job.Tile, Job.BiomeWeights, FLandscapeFoliagePlacement::GetChunkFoliageSeed(Job.Chunk)))
+            {
+                UE_LOG(LogTemp, Warning, TEXT("Landscape Bake : Chunk (%d, %d) at resolution %d failed, It will be generated at runtime"), Job.Chunk.X, Job.Chunk.Y, Resolutions[Job.Level]);
+                NumFailed++;
+            }
+        }
+
+        Jobs.Empty();
+        CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+
+        int64 NumDone = FMath::Min<int64>(FirstJob + BatchSize, NumJobs);
+        UE_LOG(LogTemp, Display, TEXT("Landscape Bake : %lld / %lld tiles (%.1f s)"), NumDone, NumJobs, FPlatformTime::Seconds() - StartTime);
+    }
+
+    if (!ArchiveWriter.Finish())
+    {
+        UE_LOG(LogTemp, Error, TEXT("Landscape Bake : Failed to write %s"), *OutputPath);
+        return 1;
+    }
+
+    UE_LOG(LogTemp, Display, TEXT("Landscape Bake : Wrote %s, %lld tiles, %lld failed, %.1f s"), *OutputPath, NumJobs - NumFailed, NumFailed, FPlatformTime::Seconds() - StartTime);
+    return NumFailed > 0 ? 1 : 0;
+}
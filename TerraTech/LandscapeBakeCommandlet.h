@@ -0,0 +1,30 @@
+// Copyright 2024 Samuel Freeman All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "LandscapeBakeCommandlet.generated.h"
+
+
+// Bakes a rectangle of chunks into a FLandscapeBakedArchive for shipping worlds with fixed seeds.
+// Every chunk is generated once per Lod resolution through LandscapeSectionData, the same path a streaming job takes,
+// then read back with its biome weights and foliage seed. Chunks are built in batches across every core, Each batch is written before the next starts.
+//
+// UnrealEditor-Cmd <Project> -run=LandscapeBake [-Landscape=/Game/Path/BP_Landscape.BP_Landscape_C] -MinX=-32 -MinY=-32 -MaxX=31 -MaxY=31
+//     [-Output=<File>] [-BatchSize=<Chunks>]
+//
+// The archive is written to Content/TerrainBake/<Landscape>.ltb by default, Set the landscapes BakedTerrainPath to TerrainBake/<Landscape>.ltb
+// and add Content/TerrainBake to the additional non asset directories to copy, The archive is memory mapped so it must be staged outside the pak.
+// The archive only loads while the generation params still match.
+UCLASS()
+class ULandscapeBakeCommandlet : public UCommandlet
+{
+    GENERATED_BODY()
+
+public:
+
+    ULandscapeBakeCommandlet();
+
+    virtual int32 Main(const FString& Params) override;
+};
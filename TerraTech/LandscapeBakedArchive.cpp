@@ -0,0 +1,322 @@
+// Copyright 2024 Samuel Freeman All rights reserved.
+
+
+#include "Framework/LandscapeBakedArchive.h"
+#include "Framework/LandscapeStreamingStats.h"
+#include "HAL/PlatformFileManager.h"
+#include "HAL/FileManager.h"
+#include "Async/MappedFileHandle.h"
+
+
+namespace LandscapeBakedArchive
+{
+    static constexpr uint32 FileMagic = 0x3142544C; // "LTB1"
+    static constexpr uint32 FileVersion = 4;
+
+    // Archive layout, Header, int32 Resolutions[NumLevels], then one int64 file offset per chunk and level (0 when the tile is missing),
+    // chunks row by row from ChunkMin, then the tile payloads.
+    struct FArchiveHeader
+    {
+        uint32 Magic;
+        uint32 Version;
+        uint64 ParamsSignature;
+        int32 ChunkMinX;
+        int32 ChunkMinY;
+        int32 ChunkMaxX;
+        int32 ChunkMaxY;
+        int32 NumLevels;
+        int32 NumBiomes;
+    };
+
+    // Tile payload, Header followed by the heightfield payload (FLandscapeHeightfieldTile::WritePayload),
+    // then NumBiomes planes of (Resolution + 1)^2 uint8 biome weights.
+    struct FTileHeader
+    {
+        int32 Resolution;
+        float Size;
+        float OriginX;
+        float OriginY;
+        float HeightOrigin;
+        float HeightStep;
+        uint32 FoliageSeed;
+        int32 NumBiomes;
+        uint32 bHasColors;
+        uint32 bHasUVs;
+    };
+
+    static int64 GetHeightfieldSize(const FTileHeader& InHeader)
+    {
+        return FLandscapeHeightfieldTile::GetPayloadSize(InHeader.Resolution, InHeader.bHasColors != 0, InHeader.bHasUVs != 0);
+    }
+
+    static int64 GetTileSize(const FTileHeader& InHeader)
+    {
+        return sizeof(FTileHeader) + GetHeightfieldSize(InHeader) + FMath::Square(int64(InHeader.Resolution) + 1) * InHeader.NumBiomes;
+    }
+}
+
+FLandscapeBakedArchive::~FLandscapeBakedArchive()
+{
+    // The region has to go before the file it maps.
+    MappedRegion.Reset();
+    MappedFile.Reset();
+}
+
+TSharedPtr<FLandscapeBakedArchive, ESPMode::ThreadSafe> FLandscapeBakedArchive::Open(const FString& InFilePath, uint64 InParamsSignature)
+{
+    using namespace LandscapeBakedArchive;
+
+    IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+    if (!PlatformFile.FileExists(*InFilePath))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Landscape Baked Archive : %s was not found, Falling back to procedural generation"), *InFilePath);
+        return nullptr;
+    }
+
+    TSharedPtr<FLandscapeBakedArchive, ESPMode::ThreadSafe> Archive = MakeShareable(new FLandscapeBakedArchive());
+    Archive->MappedFile.Reset(PlatformFile.OpenMapped(*InFilePath));
+    if (!Archive->MappedFile)
+    {
+        // Files inside a pak can not be mapped, The archive has to be staged as a loose file.
+        UE_LOG(LogTemp, Warning, TEXT("Landscape Baked Archive : %s could not be memory mapped, Stage it as a non UFS file, Falling back to procedural generation"), *InFilePath);
+        return nullptr;
+    }
+    if (Archive->MappedFile->GetFileSize() < int64(sizeof(FArchiveHeader)))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Landscape Baked Archive : %s is truncated, Falling back to procedural generation"), *InFilePath);
+        return nullptr;
+    }
+
+    Archive->MappedRegion.Reset(Archive->MappedFile->MapRegion(0, Archive->MappedFile->GetFileSize()));
+    if (!Archive->MappedRegion)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Landscape Baked Archive : %s could not be memory mapped, Falling back to procedural generation"), *InFilePath);
+        return nullptr;
+    }
+    Archive->FileData = Archive->MappedRegion->GetMappedPtr();
+    Archive->FileSize = Archive->MappedRegion->GetMappedSize();
+
+    FArchiveHeader Header;
+    FMemory::Memcpy(&Header, Archive->FileData, sizeof(FArchiveHeader));
+    if (Header.Magic != FileMagic || Header.Version != FileVersion || Header.NumLevels <= 0 || Header.NumBiomes < 0
+        || Header.ChunkMaxX < Header.ChunkMinX || Header.ChunkMaxY < Header.ChunkMinY)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Landscape Baked Archive : %s is not a baked terrain archive"), *InFilePath);
+        return nullptr;
+    }
+    if (Header.ParamsSignature != InParamsSignature)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Landscape Baked Archive : %s was baked from other generation params, Falling back to procedural generation"), *InFilePath);
+        return nullptr;
+    }
+
+    int64 NumChunks = int64(Header.ChunkMaxX - Header.ChunkMinX + 1) * int64(Header.ChunkMaxY - Header.ChunkMinY + 1);
+    int64 IndexOffset = Align(int64(sizeof(FArchiveHeader)) + int64(Header.NumLevels) * int64(sizeof(int32)), int64(sizeof(int64)));
+    if (IndexOffset + NumChunks * Header.NumLevels * int64(sizeof(int64)) > Archive->FileSize)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Landscape Baked Archive : %s is truncated, Falling back to procedural generation"), *InFilePath);
+        return nullptr;
+    }
+
+    Archive->ChunkMin = FIntPoint(Header.ChunkMinX, Header.ChunkMinY);
+    Archive->ChunkMax = FIntPoint(Header.ChunkMaxX, Header.ChunkMaxY);
+    Archive->NumBiomes = Header.NumBiomes;
+    Archive->Resolutions.SetNumUninitialized(Header.NumLevels);
+    FMemory::Memcpy(Archive->Resolutions.GetData(), Archive->FileData + sizeof(FArchiveHeader), Header.NumLevels * sizeof(int32));
+
+    // The writer pads the index to 8 bytes so it can be read in place.
+    Archive->TileOffsets = reinterpret_cast<const int64*>(Archive->FileData + IndexOffset);
+    return Archive;
+}
+
+const uint8* FLandscapeBakedArchive::FindTileData(const FIntPoint& InChunk, int32 InResolution) const
+{
+    using namespace LandscapeBakedArchive;
+
+    int32 Level = Resolutions.IndexOfByKey(InResolution);
+    if (Level == INDEX_NONE || !Contains(InChunk))
+    {
+        return nullptr;
+    }
+
+    int64 ChunkIndex = int64(InChunk.Y - ChunkMin.Y) * (ChunkMax.X - ChunkMin.X + 1) + (InChunk.X - ChunkMin.X);
+    int64 TileOffset = TileOffsets[ChunkIndex * Resolutions.Num() + Level];
+    if (TileOffset <= 0 || TileOffset + int64(sizeof(FTileHeader)) > FileSize)
+    {
+        return nullptr;
+    }
+
+    // Tiles only carry colors and UVs when the section had them, so the size is read from each tile.
+    FTileHeader Header;
+    FMemory::Memcpy(&Header, FileData + TileOffset, sizeof(FTileHeader));
+    if (Header.Resolution != InResolution || Header.NumBiomes != NumBiomes || TileOffset + GetTileSize(Header) > FileSize)
+    {
+        return nullptr;
+    }
+    return FileData + TileOffset;
+}
+
+bool FLandscapeBakedArchive::LoadHeightfield(const FIntPoint& InChunk, int32 InResolution, FLandscapeHeightfieldTile& OutTile) const
+{
+    using namespace LandscapeBakedArchive;
+    LANDSCAPE_SCOPE(STAT_LandscapeCacheLoad);
+
+    const uint8* TileData = FindTileData(InChunk, InResolution);
+    if (!TileData)
+    {
+        return false;
+    }
+
+    FTileHeader Header;
+    FMemory::Memcpy(&Header, TileData, sizeof(FTileHeader));
+
+    OutTile.Resolution = Header.Resolution;
+    OutTile.Size = Header.Size;
+    OutTile.Origin = FVector2f(Header.OriginX, Header.OriginY);
+    OutTile.HeightQuantization.Origin = Header.HeightOrigin;
+    OutTile.HeightQuantization.Step = Header.HeightStep;
+    OutTile.ReadPayload(TileData + sizeof(FTileHeader), Header.bHasColors != 0, Header.bHasUVs != 0);
+    return true;
+}
+
+bool FLandscapeBakedArchive::LoadFoliageInputs(const FIntPoint& InChunk, int32 InResolution, TArray<float>& OutBiomeWeights, uint32& OutFoliageSeed) const
+{
+    using namespace LandscapeBakedArchive;
+
+    const uint8* TileData = FindTileData(InChunk, InResolution);
+    if (!TileData)
+    {
+        return false;
+    }
+
+    FTileHeader Header;
+    FMemory::Memcpy(&Header, TileData, sizeof(FTileHeader));
+
+    int32 NumVertices = FMath::Square(Header.Resolution + 1);
+    const uint8* WeightData = TileData + sizeof(FTileHeader) + GetHeightfieldSize(Header);
+
+    OutBiomeWeights.SetNumUninitialized(NumVertices * Header.NumBiomes);
+    for (int32 i = 0; i < OutBiomeWeights.Num(); i++)
+    {
+        OutBiomeWeights[i] = float(WeightData[i]) * (1.0f / 255.0f);
+    }
+    OutFoliageSeed = Header.FoliageSeed;
+    return true;
+}
+
+FLandscapeBakedArchiveWriter::FLandscapeBakedArchiveWriter(const FString& InFilePath, uint64 InParamsSignature, const FIntPoint& InChunkMin, const FIntPoint& InChunkMax,
+    const TArray<int32>& InResolutions, int32 InNumBiomes)
+    : FilePath(InFilePath)
+    , TempPath(InFilePath + TEXT(".") + FGuid::NewGuid().ToString() + TEXT(".tmp"))
+    , ChunkMin(InChunkMin)
+    , ChunkMax(InChunkMax)
+    , NumBiomes(InNumBiomes)
+    , Resolutions(InResolutions)
+{
+    using namespace LandscapeBakedArchive;
+
+    Writer.Reset(IFileManager::Get().CreateFileWriter(*TempPath));
+    if (!Writer)
+    {
+        return;
+    }
+
+    int64 NumChunks = int64(ChunkMax.X - ChunkMin.X + 1) * int64(ChunkMax.Y - ChunkMin.Y + 1);
+    TileOffsets.SetNumZeroed(NumChunks * Resolutions.Num());
+
+    FArchiveHeader Header;
+    Header.Magic = FileMagic;
+    Header.Version = FileVersion;
+    Header.ParamsSignature = InParamsSignature;
+    Header.ChunkMinX = ChunkMin.X;
+    Header.ChunkMinY = ChunkMin.Y;
+    Header.ChunkMaxX = ChunkMax.X;
+    Header.ChunkMaxY = ChunkMax.Y;
+    Header.NumLevels = Resolutions.Num();
+    Header.NumBiomes = NumBiomes;
+    Writer->Serialize(&Header, sizeof(FArchiveHeader));
+    Writer->Serialize(Resolutions.GetData(), Resolutions.Num() * sizeof(int32));
+
+    // Padded so the index is 8 byte aligned when mapped, It is written for real once every tile is in.
+    IndexOffset = Align(Writer->Tell(), int64(sizeof(int64)));
+    TArray<uint8> Placeholder;
+    Placeholder.SetNumZeroed(IndexOffset - Writer->Tell() + TileOffsets.Num() * sizeof(int64));
+    Writer->Serialize(Placeholder.GetData(), Placeholder.Num());
+}
+
+FLandscapeBakedArchiveWriter::~FLandscapeBakedArchiveWriter()
+{
+    if (Writer)
+    {
+        Writer->Close();
+        Writer.Reset();
+        IFileManager::Get().Delete(*TempPath);
+    }
+}
+
+bool FLandscapeBakedArchiveWriter::AddTile(const FIntPoint& InChunk, const FLandscapeHeightfieldTile& InTile, TConstArrayView<float> InBiomeWeights, uint32 InFoliageSeed)
+{
+    using namespace LandscapeBakedArchive;
+
+    int32 Level = Resolutions.IndexOfByKey(InTile.Resolution);
+    int32 NumVertices = InTile.Heights.Num();
+    if (!Writer || !InTile.IsValid() || Level == INDEX_NONE || InChunk.X < ChunkMin.X || InChunk.Y < ChunkMin.Y || InChunk.X > ChunkMax.X || InChunk.Y > ChunkMax.Y
+        || (!InBiomeWeights.IsEmpty() && InBiomeWeights.Num() != NumVertices * NumBiomes))
+    {
+        return false;
+    }
+
+    FTileHeader Header;
+    Header.Resolution = InTile.Resolution;
+    Header.Size = InTile.Size;
+    Header.OriginX = InTile.Origin.X;
+    Header.OriginY = InTile.Origin.Y;
+    Header.HeightOrigin = InTile.HeightQuantization.Origin;
+    Header.HeightStep = InTile.HeightQuantization.Step;
+    Header.FoliageSeed = InFoliageSeed;
+    Header.NumBiomes = NumBiomes;
+    Header.bHasColors = InTile.Colors.IsEmpty() ? 0 : 1;
+    Header.bHasUVs = InTile.UVs.IsEmpty() ? 0 : 1;
+
+    // Tiles without weights still store zeroed planes so every biome plane has the same layout.
+    TArray<uint8> BiomeWeights;
+    BiomeWeights.SetNumZeroed(NumVertices * NumBiomes);
+    for (int32 i = 0; i < InBiomeWeights.Num(); i++)
+    {
+        BiomeWeights[i] = uint8(FMath::Clamp(FMath::RoundToInt32(InBiomeWeights[i] * 255.0f), 0, 255));
+    }
+
+    int64 ChunkIndex = int64(InChunk.Y - ChunkMin.Y) * (ChunkMax.X - ChunkMin.X + 1) + (InChunk.X - ChunkMin.X);
+    TileOffsets[ChunkIndex * Resolutions.Num() + Level] = Writer->Tell();
+
+    TArray<uint8> HeightfieldData;
+    HeightfieldData.SetNumUninitialized(InTile.GetPayloadSize());
+    InTile.WritePayload(HeightfieldData.GetData());
+
+    Writer->Serialize(&Header, sizeof(FTileHeader));
+    Writer->Serialize(HeightfieldData.GetData(), HeightfieldData.Num());
+    Writer->Serialize(BiomeWeights.GetData(), BiomeWeights.Num());
+    return !Writer->IsError();
+}
+
+bool FLandscapeBakedArchiveWriter::Finish()
+{
+    if (!Writer)
+    {
+        return false;
+    }
+
+    Writer->Seek(IndexOffset);
+    Writer->Serialize(TileOffsets.GetData(), TileOffsets.Num() * sizeof(int64));
+    bool bWritten = !Writer->IsError() && Writer->Close();
+    Writer.Reset();
+
+    // Moved into place only once complete so a running game never maps a half written archive.
+    IFileManager& FileManager = IFileManager::Get();
+    if (!bWritten || !FileManager.Move(*FilePath, *TempPath, true))
+    {
+        FileManager.Delete(*TempPath);
+        return false;
+    }
+    return true;
+}
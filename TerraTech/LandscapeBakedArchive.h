@@ -0,0 +1,88 @@
+// Copyright 2024 Samuel Freeman All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Framework/LandscapeHeightfield.h"
+
+class IMappedFileHandle;
+class IMappedFileRegion;
+class FArchive;
+
+
+// Terrain baked offline by ULandscapeBakeCommandlet for a rectangle of chunks, so shipped worlds stream tiles instead of evaluating noise.
+// Every chunk is stored once per Lod resolution (the pyramid levels, finest first) with its heights, normals, colors and UVs as FLandscapeHeightfieldTile holds them,
+// the biome blend weights on the same grid quantized to 8 bits, and the seed its foliage is placed from.
+// Sections rebuilt from a tile match generated ones exactly, Only biome filtered foliage can differ where a weight sits within 1 / 255 of a layers threshold.
+// The whole file is memory mapped and tiles are found through a dense index, so lookups are safe from any thread and never allocate past the copy out.
+// Chunks outside the baked rectangle, or resolutions that were not baked, are left to the procedural path.
+class FLandscapeBakedArchive
+{
+public:
+
+    ~FLandscapeBakedArchive();
+
+    // Returns nullptr when the file is missing, corrupt, or was baked from other generation params.
+    static TSharedPtr<FLandscapeBakedArchive, ESPMode::ThreadSafe> Open(const FString& InFilePath, uint64 InParamsSignature);
+
+    bool Contains(const FIntPoint& InChunk) const { return InChunk.X >= ChunkMin.X && InChunk.Y >= ChunkMin.Y && InChunk.X <= ChunkMax.X && InChunk.Y <= ChunkMax.Y; }
+
+    bool LoadHeightfield(const FIntPoint& InChunk, int32 InResolution, FLandscapeHeightfieldTile& OutTile) const;
+
+    // OutBiomeWeights is planar like FLandscapeBiomePointCache::ComputeTileWeights, on the grid of the tile at InResolution.
+    bool LoadFoliageInputs(const FIntPoint& InChunk, int32 InResolution, TArray<float>& OutBiomeWeights, uint32& OutFoliageSeed) const;
+
+    FIntPoint GetChunkMin() const { return ChunkMin; }
+    FIntPoint GetChunkMax() const { return ChunkMax; }
+    int32 GetNumBiomes() const { return NumBiomes; }
+    const TArray<int32>& GetResolutions() const { return Resolutions; }
+
+private:
+
+    FLandscapeBakedArchive() {}
+
+    // Start of the tile payload for the chunk and resolution, nullptr when it was not baked.
+    const uint8* FindTileData(const FIntPoint& InChunk, int32 InResolution) const;
+
+    TUniquePtr<IMappedFileHandle> MappedFile;
+    TUniquePtr<IMappedFileRegion> MappedRegion;
+    const uint8* FileData = nullptr;
+    int64 FileSize = 0;
+    const int64* TileOffsets = nullptr;
+
+    FIntPoint ChunkMin = FIntPoint::ZeroValue;
+    FIntPoint ChunkMax = FIntPoint::ZeroValue;
+    int32 NumBiomes = 0;
+    TArray<int32> Resolutions;
+};
+
+// Writes a baked archive, Tiles are streamed to disk as they are added so a large bake never holds more than one batch in memory.
+// The index is written once Finish is called, An archive that was never finished is left as a temporary file and never opened.
+class FLandscapeBakedArchiveWriter
+{
+public:
+
+    // InResolutions are the pyramid levels, finest first.
+    FLandscapeBakedArchiveWriter(const FString& InFilePath, uint64 InParamsSignature, const FIntPoint& InChunkMin, const FIntPoint& InChunkMax, const TArray<int32>& InResolutions, int32 InNumBiomes);
+    ~FLandscapeBakedArchiveWriter();
+
+    bool IsValid() const { return Writer.IsValid(); }
+
+    // InBiomeWeights must hold InNumBiomes planar weights per vertex of InTile, or be empty when no biomes were baked.
+    bool AddTile(const FIntPoint& InChunk, const FLandscapeHeightfieldTile& InTile, TConstArrayView<float> InBiomeWeights, uint32 InFoliageSeed);
+
+    bool Finish();
+
+private:
+
+    FString FilePath;
+    FString TempPath;
+    TUniquePtr<FArchive> Writer;
+
+    FIntPoint ChunkMin;
+    FIntPoint ChunkMax;
+    int32 NumBiomes;
+    TArray<int32> Resolutions;
+    TArray<int64> TileOffsets;
+    int64 IndexOffset = 0;
+};
@@ -0,0 +1,405 @@
+// Copyright 2024 Samuel Freeman All rights reserved.
+
+
+#include "Framework/LandscapeBenchmarkCommandlet.h"
+#include "Framework/LandscapeCore.h"
+#include "Framework/LandscapeSectionData.h"
+#include "Framework/LandscapeChunkScheduler.h"
+#include "Framework/LandscapeBiomePointCache.h"
+#include "Framework/LandscapeSectionTopology.h"
+#include "Async/Async.h"
+#include "Misc/QueuedThreadPool.h"
+#include "HAL/PlatformTime.h"
+#include "HAL/PlatformMemory.h"
+#include "HAL/PlatformProcess.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonWriter.h"
+#include "Serialization/JsonSerializer.h"
+#include "UObject/StrongObjectPtr.h"
+#include <atomic>
+
+
+// Reads a comma separated list of integers, Returns InDefault when the switch is missing.
+static TArray<int32> ParseIntList(const FString& InParams, const TCHAR* InMatch, const TArray<int32>& InDefault)
+{
+    FString ListText;
+    if (!FParse::Value(*InParams, InMatch, ListText, false))
+    {
+        return InDefault;
+    }
+
+    TArray<FString> Entries;
+    ListText.ParseIntoArray(Entries, TEXT(","));
+
+    TArray<int32> Values;
+    for (const FString& Entry : Entries)
+    {
+        Values.Add(FCString::Atoi(*Entry));
+    }
+    return Values;
+}
+
+FLandscapeBenchmarkMachine FLandscapeBenchmarkMachine::GetCurrent()
+{
+    FLandscapeBenchmarkMachine Machine;
+    Machine.Name = FPlatformProcess::ComputerName();
+    Machine.NumCores = FPlatformMisc::NumberOfCoresIncludingHyperthreads();
+    return Machine;
+}
+
+ULandscapeBenchmarkCommandlet::ULandscapeBenchmarkCommandlet()
+{
+    IsClient = false;
+    IsServer = false;
+    LogToConsole = true;
+}
+
+int32 ULandscapeBenchmarkCommandlet::Main(const FString& Params)
+{
+    TArray<int32> Resolutions = ParseIntList(Params, TEXT("Resolutions="), { 16, 32, 64, 128 });
+    TArray<int32> ThreadCounts = ParseIntList(Params, TEXT("Threads="), { 1, FMath::Max(FPlatformMisc::NumberOfWorkerThreadsToSpawn(), 1) });
+
+    int32 NumChunks = 64;
+    int32 NumIterations = 3;
+    double Tolerance = 0.1;
+    double MemoryTolerance = 0.25;
+    FParse::Value(*Params, TEXT("Chunks="), NumChunks);
+    FParse::Value(*Params, TEXT("Iterations="), NumIterations);
+    FParse::Value(*Params, TEXT("Tolerance="), Tolerance);
+    FParse::Value(*Params, TEXT("MemoryTolerance="), MemoryTolerance);
+    NumChunks = FMath::Max(NumChunks, 1);
+    NumIterations = FMath::Max(NumIterations, 1);
+
+    FLandscapeBenchmarkMachine CurrentMachine = FLandscapeBenchmarkMachine::GetCurrent();
+    FString BaselinePath = FPaths::ProjectDir() / FString::Printf(TEXT("Benchmarks/LandscapeBenchmarkBaseline_%s.json"), *CurrentMachine.Name);
+    FString ReportPath = FPaths::ProjectSavedDir() / TEXT("Benchmarks/LandscapeBenchmark.json");
+    FParse::Value(*Params, TEXT("Baseline="), BaselinePath);
+    FParse::Value(*Params, TEXT("Report="), ReportPath);
+    bool bWriteBaseline = FParse::Param(*Params, TEXT("WriteBaseline"));
+
+    TArray<TPair<FString, ALandscapeCore*>> Presets;
+    FString PresetList;
+    if (FParse::Value(*Params, TEXT("Presets="), PresetList, false))
+    {
+        TArray<FString> PresetPaths;
+        PresetList.ParseIntoArray(PresetPaths, TEXT(","));
+        for (const FString& PresetPath : PresetPaths)
+        {
+            UClass* PresetClass = LoadClass<ALandscapeCore>(nullptr, *PresetPath);
+            if (!PresetClass)
+            {
+                UE_LOG(LogTemp, Error, TEXT("Landscape Benchmark : Could not load landscape class %s"), *PresetPath);
+                return 1;
+            }
+            Presets.Emplace(PresetClass->GetName(), PresetClass->GetDefaultObject<ALandscapeCore>());
+        }
+    }
+    else
+    {
+        Presets.Emplace(TEXT("Default"), GetMutableDefault<ALandscapeCore>());
+    }
+
+    TArray<FLandscapeBenchmarkResult> Results;
+    for (const TPair<FString, ALandscapeCore*>& Preset : Presets)
+    {
+        Preset.Value->LandscapeNoiseParams.SetupNoise();
+
+        for (int32 Resolution : Resolutions)
+        {
+            // Section topology and stitching assume a multiple of four, the same as SetCurrentParams enforces.
+            if (Resolution < 4 || Resolution % 4 != 0)
+            {
+                UE_LOG(LogTemp, Warning, TEXT("Landscape Benchmark : Skipping resolution %d, Resolutions must be a multiple of 4"), Resolution);
+                continue;
+            }
+
+            for (int32 NumThreads : ThreadCounts)
+            {
+                NumThreads = FMath::Max(NumThreads, 1);
+
+                FLandscapeBenchmarkResult BestResult;
+                for (int32 Iteration = 0; Iteration < NumIterations; Iteration++)
+                {
+                    FLandscapeBenchmarkResult Result = RunConfiguration(Preset.Value, Preset.Key, Resolution, NumThreads, NumChunks);
+                    if (Iteration == 0)
+                    {
+                        BestResult = Result;
+                        continue;
+                    }
+                    BestResult.ChunksPerSecond = FMath::Max(BestResult.ChunksPerSecond, Result.ChunksPerSecond);
+                    BestResult.NanosecondsPerVertex = FMath::Min(BestResult.NanosecondsPerVertex, Result.NanosecondsPerVertex);
+                    BestResult.PeakMemoryMB = FMath::Min(BestResult.PeakMemoryMB, Result.PeakMemoryMB);
+                }
+
+                UE_LOG(LogTemp, Display, TEXT("Landscape Benchmark : %-32s %8.1f chunks/s %8.2f ns/vertex %8.1f MB peak"),
+                    *BestResult.GetKey(), BestResult.ChunksPerSecond, BestResult.NanosecondsPerVertex, BestResult.PeakMemoryMB);
+                Results.Add(BestResult);
+            }
+        }
+    }
+
+    if (!SaveResults(Results, ReportPath))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Landscape Benchmark : Failed to write report %s"), *ReportPath);
+    }
+
+    if (bWriteBaseline)
+    {
+        if (!SaveResults(Results, BaselinePath))
+        {
+            UE_LOG(LogTemp, Error, TEXT("Landscape Benchmark : Failed to write baseline %s"), *BaselinePath);
+            return 1;
+        }
+        UE_LOG(LogTemp, Display, TEXT("Landscape Benchmark : Wrote baseline %s"), *BaselinePath);
+        return 0;
+    }
+
+    TMap<FString, FLandscapeBenchmarkResult> Baseline;
+    FLandscapeBenchmarkMachine BaselineMachine;
+    if (!LoadResults(BaselinePath, Baseline, BaselineMachine))
+    {
+        UE_LOG(LogTemp, Error, TEXT("Landscape Benchmark : No baseline at %s, Run with -WriteBaseline on this machine to create one"), *BaselinePath);
+        return 1;
+    }
+
+    if (!(BaselineMachine == CurrentMachine))
+    {
+        UE_LOG(LogTemp, Error, TEXT("Landscape Benchmark : Baseline %s was written on %s (%d cores), This machine is %s (%d cores)"),
+            *BaselinePath, *BaselineMachine.Name, BaselineMachine.NumCores, *CurrentMachine.Name, CurrentMachine.NumCores);
+        return 1;
+    }
+
+    int32 NumFailures = CompareToBaseline(Results, Baseline, Tolerance, MemoryTolerance);
+    if (NumFailures > 0)
+    {
+        UE_LOG(LogTemp, Error, TEXT("Landscape Benchmark : %d failure(s) against %s"), NumFailures, *BaselinePath);
+        return 1;
+    }
+
+    UE_LOG(LogTemp, Display, TEXT("Landscape Benchmark : No regressions against %s"), *BaselinePath);
+    return 0;
+}
+
+// Builds InNumChunks sections in a square around the origin, The sections and meshes are created up front on the game thread
+// so only the worker side generation is timed, the same part a streaming job runs off the game thread.
+FLandscapeBenchmarkResult ULandscapeBenchmarkCommandlet::RunConfiguration(ALandscapeCore* InPreset, const FString& InPresetName, int32 InResolution, int32 InNumThreads, int32 InNumChunks) const
+{
+    FLandscapeBenchmarkResult Result;
+    Result.Preset = InPresetName;
+    Result.Resolution = InResolution;
+    Result.NumThreads = InNumThreads;
+    Result.NumChunks = InNumChunks;
+
+    // Shared generation state is rebuilt every run, as InitilizeLandscape does, so no cached biome points carry over between runs.
+    TSharedPtr<ScatteredBiomeBlender> BiomeBlender = MakeShared<ScatteredBiomeBlender>();
+    BiomeBlender->Initialize(InPreset->LandscapeNoiseParams.BiomeGenerationData.PointFrequency, InPreset->LandscapeNoiseParams.BiomeGenerationData.BlendRadiusPadding, InPreset->SectionScale);
+
+    TSharedPtr<FLandscapeBiomePointCache, ESPMode::ThreadSafe> BiomePointCache = MakeShared<FLandscapeBiomePointCache, ESPMode::ThreadSafe>(
+        BiomeBlender->GetBlendRadius(),
+        InPreset->SectionScale,
+        InPreset->LandscapeNoiseParams.BiomeGenerationData.Biomes.Num(),
+        [Blender = BiomeBlender](const FVector2D& InMin, const FVector2D& InMax, TArray<FVector2D>& OutLocations)
+        {
+            Blender->GatherPoints(InMin, InMax, OutLocations);
+        },
+        [NoiseParams = InPreset->LandscapeNoiseParams](double InX, double InY)
+        {
+            return NoiseParams.GetBiomeIndexAt(InX, InY);
+        });
+
+    FLandscapeSectionTopologyPtr Topology = MakeShared<const FLandscapeSectionTopology, ESPMode::ThreadSafe>(InResolution, InPreset->UVScale);
+
+    int32 ChunksPerSide = FMath::CeilToInt32(FMath::Sqrt(float(InNumChunks)));
+    float SectionScale = InPreset->SectionScale;
+
+    TArray<TStrongObjectPtr<URealtimeMeshSimple>> RealtimeMeshes;
+    TArray<TSharedPtr<LandscapeSectionData>> Sections;
+    RealtimeMeshes.Reserve(InNumChunks);
+    Sections.Reserve(InNumChunks);
+
+    for (int32 ChunkIndex = 0; ChunkIndex < InNumChunks; ChunkIndex++)
+    {
+        FIntPoint Chunk(ChunkIndex % ChunksPerSide - ChunksPerSide / 2, ChunkIndex / ChunksPerSide - ChunksPerSide / 2);
+
+        URealtimeMeshSimple* RealtimeMesh = NewObject<URealtimeMeshSimple>(GetTransientPackage(), NAME_None, RF_Transient);
+        RealtimeMeshes.Emplace(RealtimeMesh);
+
+        TSharedPtr<LandscapeSectionData> LandscapeSection = MakeShared<LandscapeSectionData>(RealtimeMesh, InPreset->StreamSet, InPreset->LandscapeNoiseParams, FChunkParams(
+            nullptr,
+            SectionScale,
+            InResolution,
+            SectionScale / InResolution,
+            InPreset->UVScale,
+            float(SectionScale * Chunk.X),
+            float(SectionScale * Chunk.Y)),
+            BiomeBlender,
+            FVector::ZeroVector,
+            nullptr,
+            InPreset->WorldXOffset,
+            InPreset->WorldYOffset);
+
+        LandscapeSection->SetCancellationToken(MakeShared<FSectionJobToken, ESPMode::ThreadSafe>(uint32(ChunkIndex + 1), false));
+        LandscapeSection->SetBiomePointCache(BiomePointCache);
+        LandscapeSection->SetSharedTopology(Topology);
+        LandscapeSection->SetCreateCollision(false);
+        Sections.Add(LandscapeSection);
+    }
+
+    FQueuedThreadPool* ThreadPool = FQueuedThreadPool::Allocate();
+    ThreadPool->Create(InNumThreads, 256 * 1024, TPri_Normal, TEXT("LandscapeBenchmarkPool"));
+
+    std::atomic<int32> NextChunk = 0;
+    std::atomic<uint64> BuildCycles = 0;
+    uint64 StartMemory = FPlatformMemory::GetStats().UsedPhysical;
+    uint64 PeakMemory = StartMemory;
+    double StartTime = FPlatformTime::Seconds();
+
+    TArray<TFuture<void>> Workers;
+    for (int32 i = 0; i < InNumThreads; i++)
+    {
+        Workers.Add(AsyncPool(*ThreadPool, [&Sections, &NextChunk, &BuildCycles]()
+            {
+                for (int32 ChunkIndex = NextChunk++; ChunkIndex < Sections.Num(); ChunkIndex = NextChunk++)
+                {
+                    uint64 StartCycles = FPlatformTime::Cycles64();
+                    Sections[ChunkIndex]->CreateChunk();
+                    BuildCycles += FPlatformTime::Cycles64() - StartCycles;
+                }
+            }));
+    }
+
+    // The game thread only samples memory while the workers run.
+    while (Workers.ContainsByPredicate([](const TFuture<void>& Worker) { return !Worker.IsReady(); }))
+    {
+        PeakMemory = FMath::Max(PeakMemory, FPlatformMemory::GetStats().UsedPhysical);
+        FPlatformProcess::Sleep(0.001f);
+    }
+    double ElapsedSeconds = FPlatformTime::Seconds() - StartTime;
+    PeakMemory = FMath::Max(PeakMemory, FPlatformMemory::GetStats().UsedPhysical);
+
+    ThreadPool->Destroy();
+    delete ThreadPool;
+
+    double NumVertices = double(InNumChunks) * FMath::Square(double(InResolution + 1));
+    Result.ChunksPerSecond = InNumChunks / FMath::Max(ElapsedSeconds, SMALL_NUMBER);
+    Result.NanosecondsPerVertex = FPlatformTime::ToSeconds64(BuildCycles.load()) * 1.0e9 / NumVertices;
+    Result.PeakMemoryMB = double(PeakMemory - StartMemory) / (1024.0 * 1024.0);
+
+    // Drop the meshes before the next run so its memory is measured from the same starting point.
+    Sections.Empty();
+    RealtimeMeshes.Empty();
+    CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+
+    return Result;
+}
+
+int32 ULandscapeBenchmarkCommandlet::CompareToBaseline(const TArray<FLandscapeBenchmarkResult>& InResults, const TMap<FString, FLandscapeBenchmarkResult>& InBaseline, double InTolerance, double InMemoryTolerance) const
+{
+    // Memory below this is within the noise of the allocator and is never counted as a regression.
+    const double MemorySlackMB = 4.0;
+
+    int32 NumRegressions = 0;
+    for (const FLandscapeBenchmarkResult& Result : InResults)
+    {
+        const FLandscapeBenchmarkResult* BaselineResult = InBaseline.Find(Result.GetKey());
+        if (!BaselineResult)
+        {
+            UE_LOG(LogTemp, Error, TEXT("Landscape Benchmark : %s has no baseline entry, Run with -WriteBaseline to add it"), *Result.GetKey());
+            NumRegressions++;
+            continue;
+        }
+
+        // Throughput and memory both grow with the number of chunks, so only runs of the same size are compared.
+        if (Result.NumChunks != BaselineResult->NumChunks)
+        {
+            UE_LOG(LogTemp, Error, TEXT("Landscape Benchmark : %s ran %d chunks, The baseline entry ran %d"), *Result.GetKey(), Result.NumChunks, BaselineResult->NumChunks);
+            NumRegressions++;
+            continue;
+        }
+
+        if (Result.ChunksPerSecond < BaselineResult->ChunksPerSecond * (1.0 - InTolerance))
+        {
+            UE_LOG(LogTemp, Error, TEXT("Landscape Benchmark : %s chunks/s regressed %.1f -> %.1f"), *Result.GetKey(), BaselineResult->ChunksPerSecond, Result.ChunksPerSecond);
+            NumRegressions++;
+        }
+        if (Result.NanosecondsPerVertex > BaselineResult->NanosecondsPerVertex * (1.0 + InTolerance))
+        {
+            UE_LOG(LogTemp, Error, TEXT("Landscape Benchmark : %s ns/vertex regressed %.2f -> %.2f"), *Result.GetKey(), BaselineResult->NanosecondsPerVertex, Result.NanosecondsPerVertex);
+            NumRegressions++;
+        }
+        if (Result.PeakMemoryMB > BaselineResult->PeakMemoryMB * (1.0 + InMemoryTolerance) + MemorySlackMB)
+        {
+            UE_LOG(LogTemp, Error, TEXT("Landscape Benchmark : %s peak memory regressed %.1f MB -> %.1f MB"), *Result.GetKey(), BaselineResult->PeakMemoryMB, Result.PeakMemoryMB);
+            NumRegressions++;
+        }
+    }
+    return NumRegressions;
+}
+
+bool ULandscapeBenchmarkCommandlet::SaveResults(const TArray<FLandscapeBenchmarkResult>& InResults, const FString& InFilePath)
+{
+    TArray<TSharedPtr<FJsonValue>> ResultValues;
+    for (const FLandscapeBenchmarkResult& Result : InResults)
+    {
+        TSharedPtr<FJsonObject> ResultObject = MakeShared<FJsonObject>();
+        ResultObject->SetStringField(TEXT("Preset"), Result.Preset);
+        ResultObject->SetNumberField(TEXT("Resolution"), Result.Resolution);
+        ResultObject->SetNumberField(TEXT("Threads"), Result.NumThreads);
+        ResultObject->SetNumberField(TEXT("Chunks"), Result.NumChunks);
+        ResultObject->SetNumberField(TEXT("ChunksPerSecond"), Result.ChunksPerSecond);
+        ResultObject->SetNumberField(TEXT("NsPerVertex"), Result.NanosecondsPerVertex);
+        ResultObject->SetNumberField(TEXT("PeakMemoryMB"), Result.PeakMemoryMB);
+        ResultValues.Add(MakeShared<FJsonValueObject>(ResultObject));
+    }
+
+    TSharedPtr<FJsonObject> RootObject = MakeShared<FJsonObject>();
+    FLandscapeBenchmarkMachine Machine = FLandscapeBenchmarkMachine::GetCurrent();
+    RootObject->SetStringField(TEXT("Machine"), Machine.Name);
+    RootObject->SetNumberField(TEXT("Cores"), Machine.NumCores);
+    RootObject->SetArrayField(TEXT("Results"), ResultValues);
+
+    FString JsonText;
+    TSharedRef<TJsonWriter<>> JsonWriter = TJsonWriterFactory<>::Create(&JsonText);
+    if (!FJsonSerializer::Serialize(RootObject.ToSharedRef(), JsonWriter))
+    {
+        return false;
+    }
+    return FFileHelper::SaveStringToFile(JsonText, *InFilePath);
+}
+
+bool ULandscapeBenchmarkCommandlet::LoadResults(const FString& InFilePath, TMap<FString, FLandscapeBenchmarkResult>& OutResults, FLandscapeBenchmarkMachine& OutMachine)
+{
+    FString JsonText;
+    if (!FFileHelper::LoadFileToString(JsonText, *InFilePath))
+    {
+        return false;
+    }
+
+    TSharedPtr<FJsonObject> RootObject;
+    TSharedRef<TJsonReader<>> JsonReader = TJsonReaderFactory<>::Create(JsonText);
+    if (!FJsonSerializer::Deserialize(JsonReader, RootObject) || !RootObject)
+    {
+        return false;
+    }
+
+    OutMachine.Name = RootObject->GetStringField(TEXT("Machine"));
+    OutMachine.NumCores = int32(RootObject->GetNumberField(TEXT("Cores")));
+
+    for (const TSharedPtr<FJsonValue>& ResultValue : RootObject->GetArrayField(TEXT("Results")))
+    {
+        const TSharedPtr<FJsonObject>& ResultObject = ResultValue->AsObject();
+        FLandscapeBenchmarkResult Result;
+        Result.Preset = ResultObject->GetStringField(TEXT("Preset"));
+        Result.Resolution = int32(ResultObject->GetNumberField(TEXT("Resolution")));
+        Result.NumThreads = int32(ResultObject->GetNumberField(TEXT("Threads")));
+        Result.NumChunks = int32(ResultObject->GetNumberField(TEXT("Chunks")));
+        Result.ChunksPerSecond = ResultObject->GetNumberField(TEXT("ChunksPerSecond"));
+        Result.NanosecondsPerVertex = ResultObject->GetNumberField(TEXT("NsPerVertex"));
+        Result.PeakMemoryMB = ResultObject->GetNumberField(TEXT("PeakMemoryMB"));
+        OutResults.Add(Result.GetKey(), Result);
+    }
+    return true;
+}
@@ -0,0 +1,73 @@
+// Copyright 2024 Samuel Freeman All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "LandscapeBenchmarkCommandlet.generated.h"
+
+class ALandscapeCore;
+
+
+// Throughput of one preset, Lod resolution and thread count combination.
+struct FLandscapeBenchmarkResult
+{
+    FString Preset;
+    int32 Resolution = 0;
+    int32 NumThreads = 0;
+    int32 NumChunks = 0;
+
+    double ChunksPerSecond = 0.0;
+
+    // Worker time per generated vertex, Summed over every thread so it does not depend on the thread count.
+    double NanosecondsPerVertex = 0.0;
+
+    // Highest physical memory use above the start of the run.
+    double PeakMemoryMB = 0.0;
+
+    FString GetKey() const { return FString::Printf(TEXT("%s_R%d_T%d"), *Preset, Resolution, NumThreads); }
+};
+
+// Machine a set of results was measured on, Results from another machine are not comparable.
+struct FLandscapeBenchmarkMachine
+{
+    FString Name;
+    int32 NumCores = 0;
+
+    static FLandscapeBenchmarkMachine GetCurrent();
+    bool operator==(const FLandscapeBenchmarkMachine& Other) const { return Name == Other.Name && NumCores == Other.NumCores; }
+};
+
+// Generates sections headless through LandscapeSectionData and compares the throughput against a stored baseline.
+// Nothing is rendered or spawned, Every chunk is built into its own transient realtime mesh the same way a streaming worker builds it,
+// on a thread pool of the requested size. Each combination is run Iterations times and the best run is kept.
+//
+// UnrealEditor-Cmd <Project> -run=LandscapeBenchmark [-Presets=/Game/Path/BP_Landscape.BP_Landscape_C,...] [-Resolutions=16,32,64,128]
+//     [-Threads=1,8] [-Chunks=64] [-Iterations=3] [-Baseline=<File>] [-Tolerance=0.1] [-MemoryTolerance=0.25] [-WriteBaseline] [-Report=<File>]
+//
+// Presets are landscape classes whose defaults supply the noise params, section scale and UV scale, The native ALandscapeCore defaults are used when none are given.
+// Baselines are kept per machine, Benchmarks/LandscapeBenchmarkBaseline_<ComputerName>.json by default, and record the machine name and core count.
+// Returns 1 when a combination is slower or uses more memory than the baseline by more than the tolerance, so the run fails CI,
+// and also when the baseline is missing, was written on another machine, or has no entry (or a different chunk count) for a combination that was run.
+// -WriteBaseline replaces the baseline with the results instead, Run it once on each CI machine and commit the file.
+UCLASS()
+class ULandscapeBenchmarkCommandlet : public UCommandlet
+{
+    GENERATED_BODY()
+
+public:
+
+    ULandscapeBenchmarkCommandlet();
+
+    virtual int32 Main(const FString& Params) override;
+
+private:
+
+    FLandscapeBenchmarkResult RunConfiguration(ALandscapeCore* InPreset, const FString& InPresetName, int32 InResolution, int32 InNumThreads, int32 InNumChunks) const;
+
+    // Logs every result that is worse than its baseline entry or has none to compare against, Returns the number of failures.
+    int32 CompareToBaseline(const TArray<FLandscapeBenchmarkResult>& InResults, const TMap<FString, FLandscapeBenchmarkResult>& InBaseline, double InTolerance, double InMemoryTolerance) const;
+
+    static bool SaveResults(const TArray<FLandscapeBenchmarkResult>& InResults, const FString& InFilePath);
+    static bool LoadResults(const FString& InFilePath, TMap<FString, FLandscapeBenchmarkResult>& OutResults, FLandscapeBenchmarkMachine& OutMachine);
+};
@@ -0,0 +1,270 @@
+// Copyright 2024 Samuel Freeman All rights reserved.
+
+
+#include "Framework/LandscapeBiomePointCache.h"
+#include "Framework/LandscapeStreamingStats.h"
+
+
+FLandscapeBiomePointCache::FLandscapeBiomePointCache(double InBlendRadius, double InBlockSize, int32 InNumBiomes, FPointGatherer InPointGatherer, TFunction<int32(double, double)> InBiomeResolver,
+    int32 InMaxBlocks)
+    : BlendRadius(InBlendRadius)
+    , BlockSize(FMath::Max(InBlockSize, UE_DOUBLE_SMALL_NUMBER))
+    , NumBiomes(FMath::Max(InNumBiomes, 1))
+    , PointGatherer(MoveTemp(InPointGatherer))
+    , BiomeResolver(MoveTemp(InBiomeResolver))
+{
+    int32 NumSets = int32(FMath::RoundUpToPowerOfTwo(uint32(FMath::Max(InMaxBlocks / SetWays, 1))));
+    SetMask = uint32(NumSets - 1);
+    Slots = MakeUnique<std::atomic<FPointBlock*>[]>(NumSets * SetWays);
+
+    for (int32 SlotIndex = 0; SlotIndex < NumSets * SetWays; SlotIndex++)
+    {
+        Slots[SlotIndex].store(nullptr, std::memory_order_relaxed);
+    }
+    ActiveReaders[0].store(0, std::memory_order_relaxed);
+    ActiveReaders[1].store(0, std::memory_order_relaxed);
+}
+
+FLandscapeBiomePointCache::~FLandscapeBiomePointCache()
+{
+    for (uint32 SlotIndex = 0; SlotIndex < (SetMask + 1) * SetWays; SlotIndex++)
+    {
+        delete Slots[SlotIndex].load(std::memory_order_relaxed);
+    }
+    for (const TPair<uint32, FPointBlock*>& RetiredBlock : RetiredBlocks)
+    {
+        delete RetiredBlock.Value;
+    }
+}
+
+void FLandscapeBiomePointCache::GatherPoints(const FVector2D& InMin, const FVector2D& InMax, TArray<FLandscapeBiomePoint>& OutPoints)
+{
+    // Every point belongs to the one block it lies in so only the blocks overlapping the bounds need to be visited.
+    int32 MinBlockX = FMath::FloorToInt32(InMin.X / BlockSize);
+    int32 MinBlockY = FMath::FloorToInt32(InMin.Y / BlockSize);
+    int32 MaxBlockX = FMath::FloorToInt32(InMax.X / BlockSize);
+    int32 MaxBlockY = FMath::FloorToInt32(InMax.Y / BlockSize);
+
+    for (int32 BlockY = MinBlockY; BlockY <= MaxBlockY; BlockY++)
+    {
+        for (int32 BlockX = MinBlockX; BlockX <= MaxBlockX; BlockX++)
+        {
+            GatherBlockPoints(FIntPoint(BlockX, BlockY), InMin, InMax, OutPoints);
+        }
+    }
+}
+
+// Each point adds (Radius^2 - Distance^2)^2 to its biome for every sample inside the blend radius, four samples per vector op.
+// Distances are taken relative to the tile origin so the kernel can run in single precision far from the world origin.
+void FLandscapeBiomePointCache::ComputeTileWeights(const FVector2D& InOrigin, double InStep, int32 InWidth, int32 InHeight, TArray<float>& OutWeights)
+{
+    LANDSCAPE_SCOPE(STAT_LandscapeBiomeBlend);
+
+    const int32 NumSamples = InWidth * InHeight;
+    OutWeights.Reset();
+    OutWeights.SetNumZeroed(NumBiomes * NumSamples);
+
+    TArray<float> TotalWeights;
+    TotalWeights.SetNumZeroed(NumSamples);
+
+    TArray<FLandscapeBiomePoint> Points;
+    FVector2D TileExtent = FVector2D((InWidth - 1) * InStep, (InHeight - 1) * InStep);
+    GatherPoints(InOrigin - FVector2D(BlendRadius), InOrigin + TileExtent + FVector2D(BlendRadius), Points);
+
+    const float Step = float(InStep);
+    const float RadiusSquared = float(BlendRadius * BlendRadius);
+    const VectorRegister4Float LaneOffsets = MakeVectorRegister(0.0f, 1.0f, 2.0f, 3.0f);
+    const VectorRegister4Float StepVector = VectorSetFloat1(Step);
+    const VectorRegister4Float RadiusSquaredVector = VectorSetFloat1(RadiusSquared);
+
+    for (const FLandscapeBiomePoint& Point : Points)
+    {
+        float PointX = float(Point.Location.X - InOrigin.X);
+        float PointY = float(Point.Location.Y - InOrigin.Y);
+        float* BiomeWeights = OutWeights.GetData() + Point.BiomeIndex * NumSamples;
+
+        int32 FirstRow = FMath::Max(0, FMath::CeilToInt32((PointY - float(BlendRadius)) / Step));
+        int32 LastRow = FMath::Min(InHeight - 1, FMath::FloorToInt32((PointY + float(BlendRadius)) / Step));
+        int32 FirstColumn = FMath::Max(0, FMath::CeilToInt32((PointX - float(BlendRadius)) / Step)) & ~3;
+        int32 LastColumn = FMath::Min(InWidth - 1, FMath::FloorToInt32((PointX + float(BlendRadius)) / Step));
+
+        for (int32 Row = FirstRow; Row <= LastRow; Row++)
+        {
+            float DeltaY = float(Row) * Step - PointY;
+            VectorRegister4Float DeltaYSquared = VectorSetFloat1(DeltaY * DeltaY);
+            float* RowWeights = BiomeWeights + Row * InWidth;
+            float* RowTotals = TotalWeights.GetData() + Row * InWidth;
+
+            int32 Column = FirstColumn;
+            for (; Column <= LastColumn && Column + 3 < InWidth; Column += 4)
+            {
+                VectorRegister4Float DeltaX = VectorSubtract(VectorMultiply(VectorAdd(VectorSetFloat1(float(Column)), LaneOffsets), StepVector), VectorSetFloat1(PointX));
+                VectorRegister4Float Falloff = VectorMax(VectorSubtract(RadiusSquaredVector, VectorAdd(VectorMultiply(DeltaX, DeltaX), DeltaYSquared)), VectorZero());
+                VectorRegister4Float Weight = VectorMultiply(Falloff, Falloff);
+
+                VectorStore(VectorAdd(VectorLoad(RowWeights + Column), Weight), RowWeights + Column);
+                VectorStore(VectorAdd(VectorLoad(RowTotals + Column), Weight), RowTotals + Column);
+            }
+            for (; Column <= LastColumn; Column++)
+            {
+                float DeltaX = float(Column) * Step - PointX;
+                float Falloff = FMath::Max(RadiusSquared - (DeltaX * DeltaX + DeltaY * DeltaY), 0.0f);
+                RowWeights[Column] += Falloff * Falloff;
+                RowTotals[Column] += Falloff * Falloff;
+            }
+        }
+    }
+
+    for (int32 SampleIndex = 0; SampleIndex < NumSamples; SampleIndex++)
+    {
+        TotalWeights[SampleIndex] = TotalWeights[SampleIndex] > 0.0f ? 1.0f / TotalWeights[SampleIndex] : 0.0f;
+    }
+
+    for (int32 BiomeIndex = 0; BiomeIndex < NumBiomes; BiomeIndex++)
+    {
+        float* BiomeWeights = OutWeights.GetData() + BiomeIndex * NumSamples;
+        int32 SampleIndex = 0;
+        for (; SampleIndex + 3 < NumSamples; SampleIndex += 4)
+        {
+            VectorStore(VectorMultiply(VectorLoad(BiomeWeights + SampleIndex), VectorLoad(TotalWeights.GetData() + SampleIndex)), BiomeWeights + SampleIndex);
+        }
+        for (; SampleIndex < NumSamples; SampleIndex++)
+        {
+            BiomeWeights[SampleIndex] *= TotalWeights[SampleIndex];
+        }
+    }
+}
+
+uint32 FLandscapeBiomePointCache::EnterRead()
+{
+    // The epoch is checked again after counting in, A reader that raced an epoch change backs out and counts in the new one.
+    for (;;)
+    {
+        uint32 Epoch = ReadEpoch.load();
+        ActiveReaders[Epoch & 1].fetch_add(1);
+        if (ReadEpoch.load() == Epoch)
+        {
+            return Epoch;
+        }
+        ActiveReaders[Epoch & 1].fetch_sub(1);
+    }
+}
+
+void FLandscapeBiomePointCache::LeaveRead(uint32 InEpoch)
+{
+    ActiveReaders[InEpoch & 1].fetch_sub(1, std::memory_order_release);
+}
+
+void FLandscapeBiomePointCache::RetireBlock(FPointBlock* InBlock)
+{
+    RetiredBlocks.Emplace(ReadEpoch.load(), InBlock);
+
+    // The epoch only moves on once the readers of the epoch before it are gone, They share a counter with the next one.
+    uint32 Epoch = ReadEpoch.load();
+    if (ActiveReaders[(Epoch + 1) & 1].load() == 0)
+    {
+        ReadEpoch.store(++Epoch);
+    }
+
+    for (int32 RetiredIndex = RetiredBlocks.Num() - 1; RetiredIndex >= 0; RetiredIndex--)
+    {
+        if (Epoch - RetiredBlocks[RetiredIndex].Key >= 2)
+        {
+            delete RetiredBlocks[RetiredIndex].Value;
+            RetiredBlocks.RemoveAtSwap(RetiredIndex, 1, false);
+        }
+    }
+}
+
+void FLandscapeBiomePointCache::GatherBlockPoints(const FIntPoint& InBlock, const FVector2D& InMin, const FVector2D& InMax, TArray<FLandscapeBiomePoint>& OutPoints)
+{
+    auto AppendPoints = [&InMin, &InMax, &OutPoints](const TArray<FLandscapeBiomePoint>& InPoints)
+        {
+            for (const FLandscapeBiomePoint& Point : InPoints)
+            {
+                if (Point.Location.X >= InMin.X && Point.Location.X <= InMax.X && Point.Location.Y >= InMin.Y && Point.Location.Y <= InMax.Y)
+                {
+                    OutPoints.Add(Point);
+                }
+            }
+        };
+
+    std::atomic<FPointBlock*>* Set = &Slots[(GetTypeHash(InBlock) & SetMask) * SetWays];
+    uint64 UseIndex = UseCounter.fetch_add(1, std::memory_order_relaxed);
+    {
+        uint32 Epoch = EnterRead();
+        for (int32 Way = 0; Way < SetWays; Way++)
+        {
+            const FPointBlock* Block = Set[Way].load(std::memory_order_acquire);
+            if (Block && Block->Block == InBlock)
+            {
+                Block->LastUsed.store(UseIndex, std::memory_order_relaxed);
+                AppendPoints(Block->Points);
+                LeaveRead(Epoch);
+                return;
+            }
+        }
+        LeaveRead(Epoch);
+    }
+
+    // Filled outside the lock, Two jobs missing the same block both compute it and the second one is dropped.
+    FPointBlock* NewBlock = new FPointBlock();
+    NewBlock->Block = InBlock;
+    MakeBlockPoints(InBlock, NewBlock->Points);
+    NewBlock->LastUsed.store(UseIndex, std::memory_order_relaxed);
+    AppendPoints(NewBlock->Points);
+
+    FWriteScopeLock WriteLock(FillLock);
+    int32 TargetWay = 0;
+    uint64 OldestUse = MAX_uint64;
+    for (int32 Way = 0; Way < SetWays; Way++)
+    {
+        const FPointBlock* Block = Set[Way].load(std::memory_order_relaxed);
+        if (Block && Block->Block == InBlock)
+        {
+            delete NewBlock;
+            return;
+        }
+
+        uint64 LastUsed = Block ? Block->LastUsed.load(std::memory_order_relaxed) : 0;
+        if (!Block || LastUsed < OldestUse)
+        {
+            TargetWay = Way;
+            OldestUse = Block ? LastUsed : 0;
+        }
+    }
+
+    // An empty way is taken first, Otherwise the least recently used block of the set is replaced.
+    FPointBlock* EvictedBlock = Set[TargetWay].exchange(NewBlock, std::memory_order_acq_rel);
+    if (EvictedBlock)
+    {
+        RetireBlock(EvictedBlock);
+    }
+    else
+    {
+        NumBlocks.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void FLandscapeBiomePointCache::MakeBlockPoints(const FIntPoint& InBlock, TArray<FLandscapeBiomePoint>& OutPoints) const
+{
+    FVector2D BlockMin(InBlock.X * BlockSize, InBlock.Y * BlockSize);
+    FVector2D BlockMax = BlockMin + FVector2D(BlockSize);
+
+    TArray<FVector2D> Locations;
+    if (PointGatherer)
+    {
+        PointGatherer(BlockMin, BlockMax, Locations);
+    }
+
+    // Blocks are half open so a point on a shared edge is only held by one of them.
+    for (const FVector2D& Location : Locations)
+    {
+        if (Location.X >= BlockMin.X && Location.X < BlockMax.X && Location.Y >= BlockMin.Y && Location.Y < BlockMax.Y)
+        {
+            FLandscapeBiomePoint& Point = OutPoints.AddDefaulted_GetRef();
+            Point.Location = Location;
+            Point.BiomeIndex = BiomeResolver ? FMath::Clamp(BiomeResolver(Location.X, Location.Y), 0, NumBiomes - 1) : 0;
+        }
+    }
+}
@@ -0,0 +1,83 @@
+// Copyright 2024 Samuel Freeman All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Misc/ScopeRWLock.h"
+#include <atomic>
+
+
+struct FLandscapeBiomePoint
+{
+    FVector2D Location = FVector2D::ZeroVector;
+    int32 BiomeIndex = 0;
+};
+
+// Cache of the scattered biome points used for biome blending, shared by every section job.
+// The points themselves come from InPointGatherer, which forwards to the ScatteredBiomeBlender so the cache blends over exactly the points
+// and radius the blender does. The world is split into blocks of InBlockSize (one chunk), Each block holds the points inside it and the biome resolved at each.
+// Filled blocks are immutable and published into a set associative table of atomic pointers, Each block hashes to one set of SetWays slots.
+// Readers only do atomic loads, so concurrent section jobs never take a lock on a hit. Filling a missing block takes FillLock,
+// And a full set evicts its least recently used block. Evicted blocks are freed once no reader that could have seen them is left (epoch based).
+class FLandscapeBiomePointCache
+{
+public:
+
+    // InPointGatherer adds the location of every point inside the bounds, Points outside them are allowed and filtered out.
+    using FPointGatherer = TFunction<void(const FVector2D& InMin, const FVector2D& InMax, TArray<FVector2D>& OutLocations)>;
+
+    FLandscapeBiomePointCache(double InBlendRadius, double InBlockSize, int32 InNumBiomes, FPointGatherer InPointGatherer, TFunction<int32(double, double)> InBiomeResolver,
+        int32 InMaxBlocks = 4096);
+    ~FLandscapeBiomePointCache();
+
+    // Adds every point within the bounds to OutPoints.
+    void GatherPoints(const FVector2D& InMin, const FVector2D& InMax, TArray<FLandscapeBiomePoint>& OutPoints);
+
+    // Computes normalized blend weights for a InWidth by InHeight tile of samples spaced InStep apart.
+    // OutWeights is planar, The weight of biome B for sample S is OutWeights[B * InWidth * InHeight + S], samples X fastest.
+    void ComputeTileWeights(const FVector2D& InOrigin, double InStep, int32 InWidth, int32 InHeight, TArray<float>& OutWeights);
+
+    int32 GetNumBiomes() const { return NumBiomes; }
+    double GetBlendRadius() const { return BlendRadius; }
+    int32 GetNumCachedBlocks() const { return NumBlocks.load(std::memory_order_relaxed); }
+
+private:
+
+    struct FPointBlock
+    {
+        FIntPoint Block = FIntPoint::ZeroValue;
+        TArray<FLandscapeBiomePoint> Points;
+        mutable std::atomic<uint64> LastUsed = 0;
+    };
+
+    static constexpr int32 SetWays = 8;
+
+    // Readers enter the current epoch for as long as they hold block pointers, Returns the epoch to leave.
+    uint32 EnterRead();
+    void LeaveRead(uint32 InEpoch);
+
+    // Called with FillLock held.
+    void RetireBlock(FPointBlock* InBlock);
+
+    // Appends the points of the block inside the bounds, Filling the block first if it is not cached.
+    void GatherBlockPoints(const FIntPoint& InBlock, const FVector2D& InMin, const FVector2D& InMax, TArray<FLandscapeBiomePoint>& OutPoints);
+    void MakeBlockPoints(const FIntPoint& InBlock, TArray<FLandscapeBiomePoint>& OutPoints) const;
+
+    double BlendRadius;
+    double BlockSize;
+    int32 NumBiomes;
+    FPointGatherer PointGatherer;
+    TFunction<int32(double, double)> BiomeResolver;
+
+    uint32 SetMask;
+    TUniquePtr<std::atomic<FPointBlock*>[]> Slots;
+    std::atomic<uint64> UseCounter = 0;
+    std::atomic<int32> NumBlocks = 0;
+
+    // Epoch E readers count in ActiveReaders[E & 1], A block retired in epoch E is freed once the epoch reaches E + 2.
+    std::atomic<uint32> ReadEpoch = 0;
+    std::atomic<int32> ActiveReaders[2];
+
+    FRWLock FillLock;
+    TArray<TPair<uint32, FPointBlock*>> RetiredBlocks;
+};
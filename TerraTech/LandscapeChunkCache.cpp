@@ -0,0 +1,230 @@
+// Copyright 2024 Samuel Freeman All rights reserved.
+
+
+#include "Framework/LandscapeChunkCache.h"
+#include "Framework/LandscapeStreamingStats.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Hash/CityHash.h"
+
+
+namespace LandscapeChunkCache
+{
+    static constexpr uint32 FileMagic = 0x3143544C; // "LTC1"
+    static constexpr uint32 FileVersion = 5;
+
+    // Tile file layout, Header followed by the tile payload (FLandscapeHeightfieldTile::WritePayload),
+    // Heights, normals, colors and UVs exactly as the tile holds them so loading is a copy per array.
+    struct FTileHeader
+    {
+        uint32 Magic;
+        uint32 Version;
+        uint64 ChunkKey;
+        int32 ChunkX;
+        int32 ChunkY;
+        int32 Resolution;
+        float Size;
+        float OriginX;
+        float OriginY;
+        float HeightOrigin;
+        float HeightStep;
+        uint32 bHasColors;
+        uint32 bHasUVs;
+    };
+
+    // Rewritten whenever a signature is opened, Trimming goes by its timestamp.
+    static const TCHAR* LastUsedMarker = TEXT("LastUsed.txt");
+
+    // Other signatures are kept this long after their last use, And the oldest are dropped sooner once the whole cache is over budget.
+    static constexpr double MaxUnusedDays = 14.0;
+    static constexpr int64 MaxCacheBytes = 2048ll * 1024 * 1024;
+}
+
+FLandscapeChunkCache::FLandscapeChunkCache(const FString& InRootDirectory, uint64 InParamsSignature)
+    : RootDirectory(InRootDirectory)
+    , CacheDirectory(InRootDirectory / FString::Printf(TEXT("%016llx"), InParamsSignature))
+    , ParamsSignature(InParamsSignature)
+{
+    FPlatformFileManager::Get().GetPlatformFile().CreateDirectoryTree(*CacheDirectory);
+    FFileHelper::SaveStringToFile(FDateTime::UtcNow().ToIso8601(), *(CacheDirectory / LandscapeChunkCache::LastUsedMarker));
+}
+
+bool FLandscapeChunkCache::Load(const FIntPoint& InChunk, int32 InResolution, FLandscapeHeightfieldTile& OutTile) const
+{
+    using namespace LandscapeChunkCache;
+    LANDSCAPE_SCOPE(STAT_LandscapeCacheLoad);
+
+    uint64 ChunkKey = MakeChunkKey(InChunk, InResolution);
+    FString ChunkPath = GetChunkPath(ChunkKey);
+    IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+
+    if (!PlatformFile.FileExists(*ChunkPath))
+    {
+        return false;
+    }
+
+    TUniquePtr<IMappedFileHandle> MappedFile(PlatformFile.OpenMapped(*ChunkPath));
+    if (!MappedFile || MappedFile->GetFileSize() < int64(sizeof(FTileHeader)))
+    {
+        return false;
+    }
+
+    TUniquePtr<IMappedFileRegion> MappedRegion(MappedFile->MapRegion(0, MappedFile->GetFileSize()));
+    if (!MappedRegion)
+    {
+        return false;
+    }
+
+    const uint8* FileData = MappedRegion->GetMappedPtr();
+    FTileHeader Header;
+    FMemory::Memcpy(&Header, FileData, sizeof(FTileHeader));
+
+    // The header repeats the inputs so a hash collision or a truncated write is never treated as a hit.
+    int64 ExpectedSize = sizeof(FTileHeader) + FLandscapeHeightfieldTile::GetPayloadSize(Header.Resolution, Header.bHasColors != 0, Header.bHasUVs != 0);
+    if (Header.Magic != FileMagic || Header.Version != FileVersion || Header.ChunkKey != ChunkKey || Header.ChunkX != InChunk.X || Header.ChunkY != InChunk.Y
+        || Header.Resolution != InResolution || MappedRegion->GetMappedSize() != ExpectedSize)
+    {
+        return false;
+    }
+
+    OutTile.Resolution = Header.Resolution;
+    OutTile.Size = Header.Size;
+    OutTile.Origin = FVector2f(Header.OriginX, Header.OriginY);
+    OutTile.HeightQuantization.Origin = Header.HeightOrigin;
+    OutTile.HeightQuantization.Step = Header.HeightStep;
+    OutTile.ReadPayload(FileData + sizeof(FTileHeader), Header.bHasColors != 0, Header.bHasUVs != 0);
+    return true;
+}
+
+bool FLandscapeChunkCache::Save(const FIntPoint& InChunk, int32 InResolution, const FLandscapeHeightfieldTile& InTile) const
+{
+    using namespace LandscapeChunkCache;
+    LANDSCAPE_SCOPE(STAT_LandscapeCacheSave);
+
+    if (!InTile.IsValid() || InTile.Resolution != InResolution)
+    {
+        return false;
+    }
+
+    uint64 ChunkKey = MakeChunkKey(InChunk, InResolution);
+
+    FTileHeader Header;
+    Header.Magic = FileMagic;
+    Header.Version = FileVersion;
+    Header.ChunkKey = ChunkKey;
+    Header.ChunkX = InChunk.X;
+    Header.ChunkY = InChunk.Y;
+    Header.Resolution = InResolution;
+    Header.Size = InTile.Size;
+    Header.OriginX = InTile.Origin.X;
+    Header.OriginY = InTile.Origin.Y;
+    Header.HeightOrigin = InTile.HeightQuantization.Origin;
+    Header.HeightStep = InTile.HeightQuantization.Step;
+    Header.bHasColors = InTile.Colors.IsEmpty() ? 0 : 1;
+    Header.bHasUVs = InTile.UVs.IsEmpty() ? 0 : 1;
+
+    TArray<uint8> FileData;
+    FileData.SetNumUninitialized(sizeof(FTileHeader) + InTile.GetPayloadSize());
+    FMemory::Memcpy(FileData.GetData(), &Header, sizeof(FTileHeader));
+    InTile.WritePayload(FileData.GetData() + sizeof(FTileHeader));
+
+    // Written to a temporary file first so a reader never maps a half written tile.
+    FString ChunkPath = GetChunkPath(ChunkKey);
+    FString TempPath = ChunkPath + TEXT(".") + FGuid::NewGuid().ToString() + TEXT(".tmp");
+    if (!FFileHelper::SaveArrayToFile(FileData, *TempPath))
+    {
+        return false;
+    }
+
+    IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+    PlatformFile.DeleteFile(*ChunkPath);
+    if (!PlatformFile.MoveFile(*ChunkPath, *TempPath))
+    {
+        PlatformFile.DeleteFile(*TempPath);
+        return false;
+    }
+    return true;
+}
+
+void FLandscapeChunkCache::TrimStaleSignatures() const
+{
+    using namespace LandscapeChunkCache;
+
+    struct FSignatureDirectory
+    {
+        FString Path;
+        FDateTime LastUsed;
+        int64 Size = 0;
+    };
+
+    IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+    TArray<FSignatureDirectory> Directories;
+    int64 TotalSize = 0;
+
+    PlatformFile.IterateDirectory(*RootDirectory, [this, &PlatformFile, &Directories](const TCHAR* InPath, bool bIsDirectory)
+        {
+            if (bIsDirectory && FPaths::GetCleanFilename(InPath) != FPaths::GetCleanFilename(CacheDirectory))
+            {
+                // Directories from before the marker existed fall back to their own timestamp.
+                FSignatureDirectory& Directory = Directories.AddDefaulted_GetRef();
+                Directory.Path = InPath;
+                Directory.LastUsed = PlatformFile.GetTimeStamp(*(Directory.Path / LastUsedMarker));
+                if (Directory.LastUsed == FDateTime::MinValue())
+                {
+                    Directory.LastUsed = PlatformFile.GetTimeStamp(InPath);
+                }
+            }
+            return true;
+        });
+
+    for (FSignatureDirectory& Directory : Directories)
+    {
+        PlatformFile.IterateDirectoryStatRecursively(*Directory.Path, [&Directory](const TCHAR* InPath, const FFileStatData& InStatData)
+            {
+                if (!InStatData.bIsDirectory)
+                {
+                    Directory.Size += InStatData.FileSize;
+                }
+                return true;
+            });
+        TotalSize += Directory.Size;
+    }
+
+    // The current signature counts against the budget but is never a candidate.
+    PlatformFile.IterateDirectoryStatRecursively(*CacheDirectory, [&TotalSize](const TCHAR* InPath, const FFileStatData& InStatData)
+        {
+            if (!InStatData.bIsDirectory)
+            {
+                TotalSize += InStatData.FileSize;
+            }
+            return true;
+        });
+
+    Directories.Sort([](const FSignatureDirectory& A, const FSignatureDirectory& B) { return A.LastUsed < B.LastUsed; });
+
+    FDateTime ExpiryTime = FDateTime::UtcNow() - FTimespan::FromDays(MaxUnusedDays);
+    for (const FSignatureDirectory& Directory : Directories)
+    {
+        if (Directory.LastUsed >= ExpiryTime && TotalSize <= MaxCacheBytes)
+        {
+            break;
+        }
+
+        if (PlatformFile.DeleteDirectoryRecursively(*Directory.Path))
+        {
+            TotalSize -= Directory.Size;
+        }
+    }
+}
+
+uint64 FLandscapeChunkCache::MakeChunkKey(const FIntPoint& InChunk, int32 InResolution) const
+{
+    int64 KeyData[4] = { int64(ParamsSignature), InChunk.X, InChunk.Y, InResolution };
+    return CityHash64(reinterpret_cast<const char*>(KeyData), sizeof(KeyData));
+}
+
+FString FLandscapeChunkCache::GetChunkPath(uint64 InChunkKey) const
+{
+    return CacheDirectory / FString::Printf(TEXT("%016llx.ltc"), InChunkKey);
+}
@@ -0,0 +1,38 @@
+// Copyright 2024 Samuel Freeman All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Framework/LandscapeHeightfield.h"
+
+
+// Optional on disk cache of generated section heightfields.
+// Every entry is keyed by a hash of the generation signature (noise params, world offsets, section scale),
+// the chunk coordinate and the Lod resolution, so a change to any input simply stops matching old entries.
+// Entries live in Saved/TerrainCache/<Signature>/ as one small tile file per chunk and resolution, read back through a memory mapped region.
+// Other signatures are kept so switching between param sets stays warm, They are only trimmed once unused for a while or over the size budget.
+// Load and Save are safe to call from section jobs on any thread.
+class FLandscapeChunkCache
+{
+public:
+
+    FLandscapeChunkCache(const FString& InRootDirectory, uint64 InParamsSignature);
+
+    bool Load(const FIntPoint& InChunk, int32 InResolution, FLandscapeHeightfieldTile& OutTile) const;
+    bool Save(const FIntPoint& InChunk, int32 InResolution, const FLandscapeHeightfieldTile& InTile) const;
+
+    // Deletes other signature directories unused for longer than MaxUnusedDays, Then the least recently used ones until the cache fits MaxCacheBytes.
+    // The current signature is never deleted.
+    void TrimStaleSignatures() const;
+
+    uint64 GetParamsSignature() const { return ParamsSignature; }
+
+private:
+
+    uint64 MakeChunkKey(const FIntPoint& InChunk, int32 InResolution) const;
+    FString GetChunkPath(uint64 InChunkKey) const;
+
+    FString RootDirectory;
+    FString CacheDirectory;
+    uint64 ParamsSignature;
+};
@@ -0,0 +1,188 @@
+// Copyright 2024 Samuel Freeman All rights reserved.
+
+
+#include "Framework/LandscapeChunkScheduler.h"
+#include "HAL/PlatformTime.h"
+
+
+void FLandscapeChunkScheduler::SetFocus(const FIntPoint& InCenterChunk, const FVector2D& InViewDirection)
+{
+    FVector2D NewViewDirection = InViewDirection.GetSafeNormal();
+    if (NewViewDirection.IsNearlyZero())
+    {
+        NewViewDirection = ViewDirection;
+    }
+
+    // Small camera movements are ignored so the order is not rebuilt every tick while looking around.
+    if (InCenterChunk != CenterChunk || FVector2D::DotProduct(NewViewDirection, ViewDirection) < 0.9f)
+    {
+        CenterChunk = InCenterChunk;
+        ViewDirection = NewViewDirection;
+        bOrderDirty = true;
+    }
+}
+
+void FLandscapeChunkScheduler::SetSecondaryFocus(const TArray<FIntPoint>& InFocusChunks)
+{
+    if (InFocusChunks != SecondaryFocusChunks)
+    {
+        SecondaryFocusChunks = InFocusChunks;
+        bOrderDirty = true;
+    }
+}
+
+void FLandscapeChunkScheduler::Enqueue(const FIntPoint& InChunk, int32 InLODDepth, bool bIsUpdate, bool bIsPrefetch)
+{
+    if (FPendingChunkJob* ExistingJob = PendingJobs.Find(InChunk))
+    {
+        // A prefetch never overrides the Lod depth a regular request has already asked for.
+        if (bIsPrefetch && !ExistingJob->bIsPrefetch)
+        {
+            return;
+        }
+
+        // A pending spawn already builds the section at whatever depth it is given, so it stays a spawn.
+        bool bWasUpdate = ExistingJob->bIsUpdate;
+        bool bWasPrefetch = ExistingJob->bIsPrefetch;
+        ExistingJob->LODDepth = InLODDepth;
+        ExistingJob->bIsUpdate = ExistingJob->bIsUpdate && bIsUpdate;
+        ExistingJob->bIsPrefetch = bIsPrefetch;
+
+        // Only the update penalty and the prefetch flag can move a merged job, Its distance is unchanged.
+        if (ExistingJob->bIsUpdate != bWasUpdate || ExistingJob->bIsPrefetch != bWasPrefetch)
+        {
+            PushJob(*ExistingJob);
+        }
+    }
+    else
+    {
+        FPendingChunkJob& NewJob = PendingJobs.Add(InChunk, FPendingChunkJob(InChunk, InLODDepth, bIsUpdate, bIsPrefetch));
+        NewJob.RequestTime = FPlatformTime::Seconds();
+        PushJob(NewJob);
+    }
+}
+
+void FLandscapeChunkScheduler::PushJob(FPendingChunkJob& InJob)
+{
+    InJob.Priority = ScoreJob(InJob);
+    InJob.Serial = ++NextSerial;
+
+    // A dirty order is rebuilt from PendingJobs on the next Dequeue anyway.
+    if (bOrderDirty)
+    {
+        return;
+    }
+
+    FDispatchEntry Entry;
+    Entry.Chunk = InJob.Chunk;
+    Entry.Priority = InJob.Priority;
+    Entry.bIsPrefetch = InJob.bIsPrefetch;
+    Entry.Serial = InJob.Serial;
+    DispatchHeap.HeapPush(Entry, &FLandscapeChunkScheduler::DispatchesBefore);
+
+    // Stale entries are only skipped on the way out, Rebuild once they outnumber the live jobs.
+    if (DispatchHeap.Num() > 2 * PendingJobs.Num() + 64)
+    {
+        bOrderDirty = true;
+    }
+}
+
+void FLandscapeChunkScheduler::Requeue(const FPendingChunkJob& InJob)
+{
+    Enqueue(InJob.Chunk, InJob.LODDepth, InJob.bIsUpdate, InJob.bIsPrefetch);
+
+    if (FPendingChunkJob* PendingJob = PendingJobs.Find(InJob.Chunk))
+    {
+        PendingJob->RequestTime = FMath::Min(PendingJob->RequestTime, InJob.RequestTime);
+    }
+}
+
+bool FLandscapeChunkScheduler::Dequeue(FPendingChunkJob& OutJob)
+{
+    if (bOrderDirty)
+    {
+        SortPendingJobs();
+    }
+
+    while (!DispatchHeap.IsEmpty())
+    {
+        FDispatchEntry Entry;
+        DispatchHeap.HeapPop(Entry, &FLandscapeChunkScheduler::DispatchesBefore, false);
+
+        // Removed jobs are left in the heap and skipped here rather than searched for on removal, So are entries a merge has pushed again.
+        const FPendingChunkJob* PendingJob = PendingJobs.Find(Entry.Chunk);
+        if (PendingJob && PendingJob->Serial == Entry.Serial)
+        {
+            PendingJobs.RemoveAndCopyValue(Entry.Chunk, OutJob);
+            return true;
+        }
+    }
+    return false;
+}
+
+void FLandscapeChunkScheduler::Remove(const FIntPoint& InChunk)
+{
+    PendingJobs.Remove(InChunk);
+}
+
+void FLandscapeChunkScheduler::RemoveAll(TFunctionRef<bool(const FPendingChunkJob&)> Predicate)
+{
+    for (auto It = PendingJobs.CreateIterator(); It; ++It)
+    {
+        if (Predicate(It.Value()))
+        {
+            It.RemoveCurrent();
+        }
+    }
+}
+
+void FLandscapeChunkScheduler::Empty()
+{
+    PendingJobs.Empty();
+    DispatchHeap.Empty();
+    SecondaryFocusChunks.Empty();
+    bOrderDirty = false;
+}
+
+float FLandscapeChunkScheduler::ScoreJob(const FPendingChunkJob& InJob) const
+{
+    FVector2D Offset(InJob.Chunk.X - CenterChunk.X, InJob.Chunk.Y - CenterChunk.Y);
+    float ChunkDistance = Offset.Size();
+    float Score = ChunkDistance;
+
+    if (ChunkDistance > KINDA_SMALL_NUMBER)
+    {
+        float Facing = FVector2D::DotProduct(Offset / ChunkDistance, ViewDirection);
+        Score *= 1.0f + ViewDirectionWeight * (1.0f - Facing) * 0.5f;
+    }
+    // Only the primary viewer has a view direction, Other viewers are ordered by distance alone.
+    for (const FIntPoint& FocusChunk : SecondaryFocusChunks)
+    {
+        Score = FMath::Min(Score, FVector2D(InJob.Chunk.X - FocusChunk.X, InJob.Chunk.Y - FocusChunk.Y).Size());
+    }
+    if (InJob.bIsUpdate)
+    {
+        Score += UpdatePenalty;
+    }
+    return Score;
+}
+
+void FLandscapeChunkScheduler::SortPendingJobs()
+{
+    DispatchHeap.Reset(PendingJobs.Num());
+
+    for (auto& JobPair : PendingJobs)
+    {
+        FPendingChunkJob& Job = JobPair.Value;
+        Job.Priority = ScoreJob(Job);
+
+        FDispatchEntry& Entry = DispatchHeap.AddDefaulted_GetRef();
+        Entry.Chunk = JobPair.Key;
+        Entry.Priority = Job.Priority;
+        Entry.bIsPrefetch = Job.bIsPrefetch;
+        Entry.Serial = Job.Serial;
+    }
+
+    DispatchHeap.Heapify(&FLandscapeChunkScheduler::DispatchesBefore);
+    bOrderDirty = false;
+}
@@ -0,0 +1,245 @@
+// Copyright 2024 Samuel Freeman All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/WeakObjectPtrTemplates.h"
+#include <atomic>
+
+class AActor;
+
+
+// A single pending section job, Spawn jobs create a new section, Update jobs move an existing section to a new Lod depth.
+// Prefetch jobs build sections ahead of the viewer before they enter the generation distance.
+struct FPendingChunkJob
+{
+    FIntPoint Chunk = FIntPoint::ZeroValue;
+    int32 LODDepth = 0;
+    bool bIsUpdate = false;
+    bool bIsPrefetch = false;
+    float Priority = 0.0f;
+
+    // FPlatformTime::Seconds when the chunk was first requested, Kept when the job is merged or deferred.
+    double RequestTime = 0.0;
+
+    // Matches the dispatch heap entry pushed for the jobs current priority, Older entries for the chunk are skipped.
+    uint32 Serial = 0;
+
+    FPendingChunkJob() {}
+
+    FPendingChunkJob(const FIntPoint& InChunk, int32 InLODDepth, bool bInIsUpdate, bool bInIsPrefetch = false)
+        : Chunk(InChunk)
+        , LODDepth(InLODDepth)
+        , bIsUpdate(bInIsUpdate)
+        , bIsPrefetch(bInIsPrefetch)
+    {
+    }
+};
+
+// An actor the landscape streams terrain around, Registered through ALandscapeCore::RegisterStreamingViewer.
+// Viewers that do not render (remote players on a server) only need collision, Their sections are hidden unless a rendering viewer also needs them.
+struct FLandscapeStreamingViewer
+{
+    TWeakObjectPtr<AActor> Actor;
+
+    // Generation distance in chunks, 0 uses the landscapes own generation distance.
+    int32 GenerationDistance = 0;
+
+    // Added to every Lod depth the viewer asks for, Positive values stream coarser sections around the viewer.
+    int32 LODBias = 0;
+
+    bool bRendersTerrain = true;
+
+    // Refreshed every landscape update.
+    FIntPoint Chunk = FIntPoint::ZeroValue;
+    FVector Velocity = FVector::ZeroVector;
+
+    FLandscapeStreamingViewer() {}
+
+    FLandscapeStreamingViewer(AActor* InActor, int32 InGenerationDistance, int32 InLODBias, bool bInRendersTerrain)
+        : Actor(InActor)
+        , GenerationDistance(InGenerationDistance)
+        , LODBias(InLODBias)
+        , bRendersTerrain(bInRendersTerrain)
+    {
+    }
+};
+
+// The square of chunks a viewer covered on the last landscape update.
+struct FLandscapeViewerWindow
+{
+    FIntPoint Center = FIntPoint::ZeroValue;
+    int32 Radius = 0;
+    int32 LODBias = 0;
+    bool bRendersTerrain = true;
+
+    FLandscapeViewerWindow() {}
+
+    FLandscapeViewerWindow(const FIntPoint& InCenter, int32 InRadius, int32 InLODBias, bool bInRendersTerrain)
+        : Center(InCenter)
+        , Radius(InRadius)
+        , LODBias(InLODBias)
+        , bRendersTerrain(bInRendersTerrain)
+    {
+    }
+
+    bool operator==(const FLandscapeViewerWindow& Other) const
+    {
+        return Center == Other.Center && Radius == Other.Radius && LODBias == Other.LODBias && bRendersTerrain == Other.bRendersTerrain;
+    }
+};
+
+// What every viewer together needs from one chunk, Kept up to date as viewer windows enter and leave the chunk.
+struct FSectionDemand
+{
+    // Finest Lod depth any viewer covering the chunk asks for.
+    int32 LODDepth = MAX_int32;
+
+    // Number of viewers whose generation distance covers the chunk, The section is removed once this drops to zero.
+    int32 ViewerCount = 0;
+
+    // Number of those viewers that render terrain, Sections only non rendering viewers need are hidden.
+    int32 RenderViewerCount = 0;
+};
+
+// Shared between the game thread and the worker building a section.
+// The game thread cancels the token when the section is removed or a newer Lod request replaces the job,
+// the worker polls it between generation phases and stops early once it is set.
+class FSectionJobToken
+{
+public:
+
+    FSectionJobToken(uint32 InGeneration, bool bInIsUpdate)
+        : Generation(InGeneration)
+        , bIsUpdate(bInIsUpdate)
+    {
+    }
+
+    void Cancel() { bCancelled.store(true, std::memory_order_relaxed); }
+    bool IsCancelled() const { return bCancelled.load(std::memory_order_relaxed); }
+
+    uint32 GetGeneration() const { return Generation; }
+    bool IsUpdate() const { return bIsUpdate; }
+
+private:
+
+    const uint32 Generation;
+    const bool bIsUpdate;
+    std::atomic<bool> bCancelled = false;
+};
+
+typedef TSharedPtr<FSectionJobToken, ESPMode::ThreadSafe> FSectionJobTokenPtr;
+
+// Handed back from a worker thread once a section job has finished building its mesh, or stopped because it was cancelled.
+struct FCompletedSectionJob
+{
+    FIntPoint Chunk = FIntPoint::ZeroValue;
+    uint32 Generation = 0;
+    bool bIsUpdate = false;
+    bool bSpawnFoliage = false;
+    bool bCancelled = false;
+
+    // Time the worker spent building the section.
+    float BuildMilliseconds = 0.0f;
+
+    FCompletedSectionJob() {}
+
+    FCompletedSectionJob(const FIntPoint& InChunk, uint32 InGeneration, bool bInIsUpdate, bool bInSpawnFoliage, bool bInCancelled, float InBuildMilliseconds)
+        : Chunk(InChunk)
+        , Generation(InGeneration)
+        , bIsUpdate(bInIsUpdate)
+        , bSpawnFoliage(bInSpawnFoliage)
+        , bCancelled(bInCancelled)
+        , BuildMilliseconds(InBuildMilliseconds)
+    {
+    }
+};
+
+// Cost of the game thread commit stage on the last frame, Kept so streaming can be watched next to the frame time.
+struct FLandscapeCommitStats
+{
+    // Results still waiting once the frames budget ran out.
+    int32 QueueDepth = 0;
+    int32 FoliageQueueDepth = 0;
+
+    int32 SectionsCommitted = 0;
+    int32 FoliageSpawned = 0;
+    double CommitMilliseconds = 0.0;
+
+    // Highest CommitMilliseconds since the landscape was initialized.
+    double PeakCommitMilliseconds = 0.0;
+};
+
+// Owns every section job that has been requested but not yet dispatched to a worker thread.
+// Jobs are handed out closest first, weighted towards the direction the viewer is facing,
+// and the order is rebuilt whenever the focus chunk or view direction changes.
+// Prefetch jobs are always handed out after every regular job.
+// The order is a binary heap, New, merged and requeued jobs are pushed onto it so only a focus change rescores every job.
+class FLandscapeChunkScheduler
+{
+public:
+
+    // Sets the chunk the viewer is standing in and the direction it is looking in (XY plane).
+    void SetFocus(const FIntPoint& InCenterChunk, const FVector2D& InViewDirection);
+
+    // Chunks of every other streaming viewer, Jobs are scored by their distance to the closest focus chunk.
+    void SetSecondaryFocus(const TArray<FIntPoint>& InFocusChunks);
+
+    // Adds a job for the chunk, If a job is already pending for the chunk its Lod depth is replaced instead.
+    // A regular request for a chunk with a pending prefetch job promotes it to a regular job.
+    void Enqueue(const FIntPoint& InChunk, int32 InLODDepth, bool bIsUpdate, bool bIsPrefetch = false);
+
+    // Puts a dequeued job back without restarting its request time.
+    void Requeue(const FPendingChunkJob& InJob);
+
+    // Pops the highest priority job, returns false when nothing is pending.
+    bool Dequeue(FPendingChunkJob& OutJob);
+
+    void Remove(const FIntPoint& InChunk);
+    void RemoveAll(TFunctionRef<bool(const FPendingChunkJob&)> Predicate);
+    void Empty();
+
+    bool Contains(const FIntPoint& InChunk) const { return PendingJobs.Contains(InChunk); }
+    int32 Num() const { return PendingJobs.Num(); }
+
+    // How much being behind the viewer pushes a chunk back, 0 = pure distance ordering, 1 = a chunk directly behind counts as twice as far away.
+    float ViewDirectionWeight = 0.5f;
+
+    // Extra distance (in chunks) added to Lod updates so holes in the terrain are filled before existing sections are refined.
+    float UpdatePenalty = 0.5f;
+
+private:
+
+    struct FDispatchEntry
+    {
+        FIntPoint Chunk = FIntPoint::ZeroValue;
+        float Priority = 0.0f;
+        bool bIsPrefetch = false;
+        uint32 Serial = 0;
+    };
+
+    // Regular jobs before prefetch jobs, then the lowest score, The top of the heap is the next job.
+    static bool DispatchesBefore(const FDispatchEntry& A, const FDispatchEntry& B)
+    {
+        if (A.bIsPrefetch != B.bIsPrefetch)
+        {
+            return !A.bIsPrefetch;
+        }
+        return A.Priority < B.Priority;
+    }
+
+    float ScoreJob(const FPendingChunkJob& InJob) const;
+    void PushJob(FPendingChunkJob& InJob);
+    void SortPendingJobs();
+
+    TMap<FIntPoint, FPendingChunkJob> PendingJobs;
+
+    // Removed and re-pushed jobs leave stale entries behind, They are skipped when popped and dropped when the heap is rebuilt.
+    TArray<FDispatchEntry> DispatchHeap;
+    uint32 NextSerial = 0;
+
+    FIntPoint CenterChunk = FIntPoint::ZeroValue;
+    TArray<FIntPoint> SecondaryFocusChunks;
+    FVector2D ViewDirection = FVector2D(1.0f, 0.0f);
+    bool bOrderDirty = false;
+};
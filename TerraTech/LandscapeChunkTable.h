@@ -0,0 +1,185 @@
+// Copyright 2024 Samuel Freeman All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/WeakObjectPtrTemplates.h"
+#include "Framework/LandscapeChunkScheduler.h"
+#include "Framework/LandscapeSectionTopology.h"
+#include "Framework/LandscapeSectionCollision.h"
+
+class URealtimeMeshComponent;
+class APCGSectionFoliage;
+class UHierarchicalInstancedStaticMeshComponent;
+class LandscapeSectionData;
+
+
+// Everything the landscape tracks for one chunk, kept together so the streaming loops touch a single slot per chunk.
+struct FLandscapeChunkRecord
+{
+    // Set once a spawn job has been issued for the chunk, Cleared when the section is removed.
+    bool bGenerated = false;
+
+    URealtimeMeshComponent* SectionMeshComponent = nullptr;
+    int32 CurrentLODDepth = 0;
+
+    // Lod depth the mesh had before the update in flight, Restored when that update is cancelled.
+    int32 PreviousLODDepth = 0;
+
+    // Generation data and token of the job currently building the section, Both are null while no job is in flight.
+    TSharedPtr<LandscapeSectionData> GenerationData;
+    FSectionJobTokenPtr JobToken;
+
+    TWeakObjectPtr<APCGSectionFoliage> FoliageSection;
+
+    // Instanced foliage placed from the heightfield, One component per foliage layer attached to the section component.
+    // FoliageRequestId is the placement the section is waiting on or showing, 0 while it has none.
+    TArray<UHierarchicalInstancedStaticMeshComponent*> FoliageComponents;
+    uint32 FoliageRequestId = 0;
+
+    // Edges captured after the last build, Used to stitch against coarser neighbours.
+    FSectionEdgeState EdgeState;
+
+    // Collision currently built for the section, Dirty once a rebuild has left the simplified collision grid behind the section.
+    ELandscapeCollisionPolicy CollisionState = ELandscapeCollisionPolicy::None;
+    bool bCollisionDirty = false;
+
+    bool HasJobInFlight() const { return GenerationData.IsValid(); }
+};
+
+// Two dimensional chunk table addressed by chunk coordinate modulo a power of two window size.
+// The window wraps around (toroidal), so when the viewer moves the chunks that leave the window free exactly the slots
+// the entering chunks land in, Nothing is rehashed or moved and a lookup is a mask and an array index.
+// A chunk whose slot is already taken by another chunk (a second viewer far away, or a section still waiting on removal)
+// is kept in a small overflow map, which is only searched while it is not empty.
+template<typename ValueType>
+class TLandscapeChunkTable
+{
+public:
+
+    // Clears the table and sizes it so any window of InMinWindowSize chunks per side maps to distinct slots.
+    void Reset(int32 InMinWindowSize)
+    {
+        SizeLog2 = FMath::CeilLogTwo(uint32(FMath::Max(InMinWindowSize, 1)));
+        Mask = (1 << SizeLog2) - 1;
+
+        Slots.Reset();
+        Slots.SetNum(1 << (SizeLog2 * 2));
+        Overflow.Empty();
+        NumSlotsUsed = 0;
+    }
+
+    void Empty()
+    {
+        Slots.Empty();
+        Overflow.Empty();
+        NumSlotsUsed = 0;
+        SizeLog2 = 0;
+        Mask = 0;
+    }
+
+    ValueType* Find(const FIntPoint& InChunk)
+    {
+        if (Slots.IsEmpty())
+        {
+            return Overflow.Find(InChunk);
+        }
+
+        FSlot& Slot = Slots[GetSlotIndex(InChunk)];
+        if (Slot.bUsed && Slot.Chunk == InChunk)
+        {
+            return &Slot.Value;
+        }
+        return Overflow.IsEmpty() ? nullptr : Overflow.Find(InChunk);
+    }
+
+    const ValueType* Find(const FIntPoint& InChunk) const
+    {
+        return const_cast<TLandscapeChunkTable*>(this)->Find(InChunk);
+    }
+
+    bool Contains(const FIntPoint& InChunk) const { return Find(InChunk) != nullptr; }
+
+    ValueType& FindOrAdd(const FIntPoint& InChunk)
+    {
+        if (ValueType* Existing = Find(InChunk))
+        {
+            return *Existing;
+        }
+
+        if (!Slots.IsEmpty())
+        {
+            FSlot& Slot = Slots[GetSlotIndex(InChunk)];
+            if (!Slot.bUsed)
+            {
+                Slot.bUsed = true;
+                Slot.Chunk = InChunk;
+                Slot.Value = ValueType();
+                NumSlotsUsed++;
+                return Slot.Value;
+            }
+        }
+        return Overflow.Add(InChunk, ValueType());
+    }
+
+    void Remove(const FIntPoint& InChunk)
+    {
+        if (!Slots.IsEmpty())
+        {
+            FSlot& Slot = Slots[GetSlotIndex(InChunk)];
+            if (Slot.bUsed && Slot.Chunk == InChunk)
+            {
+                Slot.bUsed = false;
+                Slot.Value = ValueType();
+                NumSlotsUsed--;
+                return;
+            }
+        }
+        Overflow.Remove(InChunk);
+    }
+
+    // Calls InFunc(const FIntPoint& Chunk, ValueType& Value) for every chunk in the table, The table must not be modified from InFunc.
+    template<typename FuncType>
+    void ForEach(FuncType&& InFunc)
+    {
+        if (NumSlotsUsed > 0)
+        {
+            for (FSlot& Slot : Slots)
+            {
+                if (Slot.bUsed)
+                {
+                    InFunc(Slot.Chunk, Slot.Value);
+                }
+            }
+        }
+        for (TPair<FIntPoint, ValueType>& OverflowPair : Overflow)
+        {
+            InFunc(OverflowPair.Key, OverflowPair.Value);
+        }
+    }
+
+    int32 Num() const { return NumSlotsUsed + Overflow.Num(); }
+    int32 NumOverflow() const { return Overflow.Num(); }
+    int32 GetWindowSize() const { return 1 << SizeLog2; }
+
+private:
+
+    struct FSlot
+    {
+        FIntPoint Chunk = FIntPoint::ZeroValue;
+        bool bUsed = false;
+        ValueType Value;
+    };
+
+    // Masking a two's complement coordinate is its positive modulo, so negative chunks wrap the same way as positive ones.
+    int32 GetSlotIndex(const FIntPoint& InChunk) const
+    {
+        return (InChunk.X & Mask) | ((InChunk.Y & Mask) << SizeLog2);
+    }
+
+    TArray<FSlot> Slots;
+    TMap<FIntPoint, ValueType> Overflow;
+    int32 NumSlotsUsed = 0;
+    int32 SizeLog2 = 0;
+    int32 Mask = 0;
+};
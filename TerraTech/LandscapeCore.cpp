@@ -3,6 +3,20 @@
 
 #include "Framework/LandscapeCore.h"
 #include "Framework/LandscapeSectionData.h"
+#include "Framework/LandscapeChunkScheduler.h"
+#include "Framework/LandscapeBiomePointCache.h"
+#include "Framework/LandscapeSectionTopology.h"
+#include "Framework/LandscapeHeightfield.h"
+#include "Framework/LandscapeChunkCache.h"
+#include "Framework/LandscapeBakedArchive.h"
+#include "Framework/LandscapeHeightfieldStore.h"
+#include "Framework/LandscapeChunkTable.h"
+#include "Framework/LandscapeLODRingTable.h"
+#include "Framework/LandscapeFoliagePlacement.h"
+#include "Framework/LandscapeStreamingStats.h"
+#include "Framework/LandscapeParamChange.h"
+#include "Framework/LandscapeEditLayer.h"
+#include "Components/HierarchicalInstancedStaticMeshComponent.h"
 #include "Async/Async.h"
 #include "Kismet/GameplayStatics.h"
 #include "UObject/StrongObjectPtr.h"
@@ -10,12 +24,283 @@
 #include "GeometryScript/MeshBasicEditFunctions.h"
 #include "RealtimeMeshDynamicMeshConverter.h"
 #include "Kismet/GameplayStatics.h"
+#include "Misc/Paths.h"
+#include "Misc/FileHelper.h"
+#include "Net/UnrealNetwork.h"
+#include "Hash/CityHash.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/App.h"
+#include "UObject/UObjectIterator.h"
+
+
+static TAutoConsoleVariable<bool> CVarLandscapeShowCommitStats(
+    TEXT("landscape.Streaming.ShowCommitStats"),
+    false,
+    TEXT("Shows the landscape commit queue depth and the game thread time spent committing sections every frame."));
+
+// Calls InFunc for every landscape in a live world, Used by the console commands below.
+static void ForEachLandscapeCore(TFunctionRef<void(ALandscapeCore&)> InFunc)
+{
+    for (TObjectIterator<ALandscapeCore> It; It; ++It)
+    {
+        if (!It->HasAnyFlags(RF_ClassDefaultObject | RF_ArchetypeObject) && It->GetWorld())
+        {
+            InFunc(**It);
+        }
+    }
+}
+
+static FAutoConsoleCommand LandscapeStreamingStatsCommand(
+    TEXT("landscape.Streaming.Stats"),
+    TEXT("Logs chunks per second, jobs in flight, queue depths and p50/p99 queue, build and time to visible for every landscape."),
+    FConsoleCommandDelegate::CreateLambda([]()
+        {
+            ForEachLandscapeCore([](ALandscapeCore& Landscape)
+                {
+                    Landscape.GetStreamingTelemetry().LogSummary(Landscape.GetName());
+                });
+        }));
+
+static FAutoConsoleCommand LandscapeStreamingExportCommand(
+    TEXT("landscape.Streaming.ExportCSV"),
+    TEXT("Writes the timings of the most recent section jobs of every landscape to CSV, One row per job. Optional argument: output directory (defaults to Saved/Profiling/LandscapeStreaming)."),
+    FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+        {
+            FString OutputDirectory = Args.Num() > 0 ? Args[0] : FPaths::ProfilingDir() / TEXT("LandscapeStreaming");
+            FString Timestamp = FDateTime::Now().ToString();
+
+            ForEachLandscapeCore([&](ALandscapeCore& Landscape)
+                {
+                    FString FilePath = OutputDirectory / FString::Printf(TEXT("%s_%s.csv"), *Landscape.GetName(), *Timestamp);
+                    if (Landscape.GetStreamingTelemetry().ExportCSV(FilePath))
+                    {
+                        UE_LOG(LogTemp, Display, TEXT("Landscape Streaming : Wrote %s"), *FilePath);
+                    }
+                    else
+                    {
+                        UE_LOG(LogTemp, Warning, TEXT("Landscape Streaming : Failed to write %s"), *FilePath);
+                    }
+                });
+        }));
+
+// Everything a worker needs to build one section, Captured by value so the job never reads actor state off the game thread.
+struct FSectionBuildContext
+{
+    TSharedPtr<LandscapeSectionData> LandscapeSection;
+    URealtimeMeshSimple* RealtimeMesh = nullptr;
+    FRealtimeMeshSectionGroupKey GroupKey;
+    FIntPoint Chunk = FIntPoint::ZeroValue;
+    int32 Resolution = 0;
+    bool bIsUpdate = false;
+    FSectionJobTokenPtr JobToken;
+    FLandscapeSectionTopologyPtr Topology;
+    TSharedPtr<FLandscapeChunkCache, ESPMode::ThreadSafe> ChunkCache;
+    TSharedPtr<FLandscapeHeightfieldStore, ESPMode::ThreadSafe> HeightfieldStore;
+    uint32 HeightfieldGeneration = 0;
+    bool bCreateCollision = false;
+    TSharedPtr<FLandscapeBakedArchive, ESPMode::ThreadSafe> BakedArchive;
+    FLandscapeEditSnapshot Edits;
+    FLandscapeHeightQuantization HeightQuantization;
+
+    FSectionBuildContext(const TSharedPtr<LandscapeSectionData>& InLandscapeSection, URealtimeMeshSimple* InRealtimeMesh, const FRealtimeMeshSectionGroupKey& InGroupKey,
+        const FIntPoint& InChunk, int32 InResolution, bool bInIsUpdate, const FSectionJobTokenPtr& InJobToken,
+        const FLandscapeSectionTopologyPtr& InTopology, const TSharedPtr<FLandscapeChunkCache, ESPMode::ThreadSafe>& InChunkCache,
+        const TSharedPtr<FLandscapeHeightfieldStore, ESPMode::ThreadSafe>& InHeightfieldStore)
+        : LandscapeSection(InLandscapeSection)
+        , RealtimeMesh(InRealtimeMesh)
+        , GroupKey(InGroupKey)
+        , Chunk(InChunk)
+        , Resolution(InResolution)
+        , bIsUpdate(bInIsUpdate)
+        , JobToken(InJobToken)
+        , Topology(InTopology)
+        , ChunkCache(InChunkCache)
+        , HeightfieldStore(InHeightfieldStore)
+        , HeightfieldGeneration(InHeightfieldStore ? InHeightfieldStore->GetGeneration() : 0)
+    {
+    }
+};
+
+// Hands the finished heightfield to the query store, Unless the job was cancelled and the section is about to go away.
+// The store checks the token under its lock, The game thread cancels before RemoveTile so a removed section never gets its tile back.
+static void PublishSectionHeightfield(const FSectionBuildContext& Context, FLandscapeHeightfieldTile&& InTile)
+{
+    if (Context.HeightfieldStore)
+    {
+        Context.HeightfieldStore->SetTile(Context.Chunk, MakeShared<const FLandscapeHeightfieldTile, ESPMode::ThreadSafe>(MoveTemp(InTile)), Context.HeightfieldGeneration, Context.JobToken.Get());
+    }
+}
+
+// Runs on the worker thread, Rebuilds the section from the baked archive or the disk cache when either has the tile,
+// otherwise generates it from noise and stores the result for the next visit.
+// Terrain edits go on top of whichever it was, The cache only ever holds the unedited section.
+// Either way the heightfield of the built section is published for height queries.
+static void BuildSectionOnWorker(const FSectionBuildContext& Context)
+{
+    if (Context.JobToken->IsCancelled())
+    {
+        return;
+    }
+
+    LANDSCAPE_SCOPE(STAT_LandscapeSectionBuild);
+
+    FLandscapeHeightfieldTile SectionTile;
+    bool bHasStoredTile = Context.Topology
+        && ((Context.BakedArchive && Context.BakedArchive->LoadHeightfield(Context.Chunk, Context.Resolution, SectionTile))
+            || (Context.ChunkCache && Context.ChunkCache->Load(Context.Chunk, Context.Resolution, SectionTile)));
+    if (bHasStoredTile)
+    {
+        TArray<FColor> VertexColors;
+        Context.Edits.ApplyToTile(SectionTile, nullptr, VertexColors);
+        SectionTile.ApplyToRealtimeMesh(Context.RealtimeMesh, Context.GroupKey, *Context.Topology, Context.bIsUpdate,
+            FRealtimeMeshSectionConfig(ERealtimeMeshSectionDrawType::Static, 0), Context.bCreateCollision, VertexColors);
+        PublishSectionHeightfield(Context, MoveTemp(SectionTile));
+        return;
+    }
+
+    // Edited sections are generated into a local stream set and uploaded once, from the edited tile, So the unedited section never reaches the mesh.
+    bool bHasEdits = Context.Topology && !Context.Edits.IsEmpty();
+    if (bHasEdits)
+    {
+        FRealtimeMeshStreamSet GeneratedStreams;
+        {
+            LANDSCAPE_SCOPE(STAT_LandscapeSectionGenerate);
+            Context.LandscapeSection->BuildStreamSet(GeneratedStreams);
+        }
+
+        if (Context.JobToken->IsCancelled())
+        {
+            return;
+        }
+
+        if (SectionTile.ReadFromStreams(GeneratedStreams, Context.Resolution, Context.HeightQuantization, Context.Topology.Get()))
+        {
+            if (Context.ChunkCache)
+            {
+                Context.ChunkCache->Save(Context.Chunk, Context.Resolution, SectionTile);
+            }
+
+            TArray<FColor> VertexColors;
+            Context.Edits.ApplyToTile(SectionTile, nullptr, VertexColors);
+            SectionTile.ApplyToRealtimeMesh(Context.RealtimeMesh, Context.GroupKey, *Context.Topology, Context.bIsUpdate,
+                FRealtimeMeshSectionConfig(ERealtimeMeshSectionDrawType::Static, 0), Context.bCreateCollision, VertexColors);
+            PublishSectionHeightfield(Context, MoveTemp(SectionTile));
+            return;
+        }
+        // Not a plain grid so the edits can not be applied, The section is generated as usual below.
+    }
+
+    {
+        LANDSCAPE_SCOPE(STAT_LandscapeSectionGenerate);
+        if (Context.bIsUpdate)
+        {
+            Context.LandscapeSection->UpdateSection();
+        }
+        else
+        {
+            Context.LandscapeSection->CreateChunk();
+        }
+    }
+
+    if ((Context.ChunkCache || Context.HeightfieldStore) && !Context.JobToken->IsCancelled())
+    {
+        bool bReadSection = false;
+        Context.RealtimeMesh->ProcessMesh(Context.GroupKey, [&](const FRealtimeMeshStreamSet& Streams)
+            {
+                bReadSection = SectionTile.ReadFromStreams(Streams, Context.Resolution, Context.HeightQuantization, Context.Topology.Get());
+            });
+
+        if (bReadSection)
+        {
+            if (Context.ChunkCache)
+            {
+                Context.ChunkCache->Save(Context.Chunk, Context.Resolution, SectionTile);
+            }
+            PublishSectionHeightfield(Context, MoveTemp(SectionTile));
+        }
+    }
+}
+
+
+// Calls InFunc for every chunk in InWindow that is not inside InExcludedWindow, Visits whole rows only where they lie outside it
+// so the cost is the number of chunks returned plus one step per row.
+static void ForEachChunkInWindowDifference(const FLandscapeViewerWindow& InWindow, const FLandscapeViewerWindow* InExcludedWindow, TFunctionRef<void(const FIntPoint&)> InFunc)
+{
+    FIntPoint Min = InWindow.Center - FIntPoint(InWindow.Radius);
+    FIntPoint Max = InWindow.Center + FIntPoint(InWindow.Radius);
+    FIntPoint ExcludedMin = InExcludedWindow ? InExcludedWindow->Center - FIntPoint(InExcludedWindow->Radius) : FIntPoint(MAX_int32);
+    FIntPoint ExcludedMax = InExcludedWindow ? InExcludedWindow->Center + FIntPoint(InExcludedWindow->Radius) : FIntPoint(MIN_int32);
+
+    for (int32 Y = Min.Y; Y <= Max.Y; Y++)
+    {
+        if (Y < ExcludedMin.Y || Y > ExcludedMax.Y)
+        {
+            for (int32 X = Min.X; X <= Max.X; X++)
+            {
+                InFunc(FIntPoint(X, Y));
+            }
+            continue;
+        }
+        for (int32 X = Min.X; X <= FMath::Min(Max.X, ExcludedMin.X - 1); X++)
+        {
+            InFunc(FIntPoint(X, Y));
+        }
+        for (int32 X = FMath::Max(Min.X, ExcludedMax.X + 1); X <= Max.X; X++)
+        {
+            InFunc(FIntPoint(X, Y));
+        }
+    }
+}
+
+// Calls InFunc for every chunk exactly InShell chunks (Chebyshev distance) from InCenter.
+static void ForEachChunkInShell(const FIntPoint& InCenter, int32 InShell, TFunctionRef<void(const FIntPoint&)> InFunc)
+{
+    if (InShell == 0)
+    {
+        InFunc(InCenter);
+        return;
+    }
+    for (int32 Offset = -InShell; Offset <= InShell; Offset++)
+    {
+        InFunc(InCenter + FIntPoint(Offset, -InShell));
+        InFunc(InCenter + FIntPoint(Offset, InShell));
+    }
+    for (int32 Offset = -InShell + 1; Offset <= InShell - 1; Offset++)
+    {
+        InFunc(InCenter + FIntPoint(-InShell, Offset));
+        InFunc(InCenter + FIntPoint(InShell, Offset));
+    }
+}
 
 
 // Sets default values
 ALandscapeCore::ALandscapeCore()
 {
 	PrimaryActorTick.bCanEverTick = true;
+    bReplicates = true;
+
+    // The edit layer covers the whole landscape, Clients far from the actor origin still need every tile.
+    bAlwaysRelevant = true;
+}
+
+void ALandscapeCore::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+    Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+    DOREPLIFETIME(ALandscapeCore, ReplicatedEditTiles);
+}
+
+// Landscapes saved before the interval was in seconds counted it in frames, Converted at the 60 Hz it was tuned for.
+void ALandscapeCore::PostLoad()
+{
+    Super::PostLoad();
+
+    if (UpdateInterval_DEPRECATED >= 0)
+    {
+        UpdateIntervalSeconds = float(UpdateInterval_DEPRECATED) / 60.0f;
+        UpdateInterval_DEPRECATED = INDEX_NONE;
+    }
 }
 
 void ALandscapeCore::EndPlay(const EEndPlayReason::Type EndPlayReason)
@@ -33,12 +318,18 @@ void ALandscapeCore::OnConstruction(const FTransform& Transform)
     {
         if (CheckIfDirty())
         {
-            if (GEngine)
+            // A landscape that was never generated has nothing to patch.
+            if (!bIsInitialized)
             {
-                FString Message = FString::Printf(TEXT("Landscape Dirty Performing Cleanup and Reinitilatization"));
-                UE_LOG(LogTemp, Warning, TEXT("%s"), *Message);
+                UE_LOG(LogTemp, Warning, TEXT("Landscape Dirty Performing Cleanup and Reinitilatization"));
+                RegenerateLandscape();
+                return;
             }
-            RegenerateLandscape();
+
+            FGenerationParams PreviousParams = CurrentGeneratedParams;
+            uint64 PreviousSignature = ChunkCacheSignature;
+            SetCurrentParams();
+            ApplyParamChanges(ClassifyParamChanges(PreviousParams, PreviousSignature));
         }
     }
 }
@@ -51,40 +342,222 @@ void ALandscapeCore::RegenerateLandscape()
     InitilizeLandscape();
 }
 
-void ALandscapeCore::GenerateFoliage()
+// Compares the params just set against the ones the landscape was generated with.
+// Heights depend on everything in the chunk cache signature plus the resolution of every Lod depth,
+// The ring distances and per ring settings only decide which sections exist and at which depth.
+ELandscapeParamChange ALandscapeCore::ClassifyParamChanges(const FGenerationParams& InPreviousParams, uint64 InPreviousSignature) const
+{
+    ELandscapeParamChange Changes = ELandscapeParamChange::None;
+
+    if (TerrainMaterial != InPreviousParams.TerrainMaterial)
+    {
+        Changes |= ELandscapeParamChange::Material;
+    }
+
+    if (SectionScale != InPreviousParams.SectionScale)
+    {
+        Changes |= ELandscapeParamChange::Layout;
+    }
+
+    bool bResolutionsChanged = SubDivitions != InPreviousParams.SubDivitions || bUseLODs != InPreviousParams.bUseLODs || LodDepths.Num() != InPreviousParams.LodDepths.Num();
+    bool bRingsChanged = Distance != InPreviousParams.Distance || LODDepth != InPreviousParams.LODDepth;
+    for (int32 i = 0; i < FMath::Min(LodDepths.Num(), InPreviousParams.LodDepths.Num()); i++)
+    {
+        const auto& LodDepth = LodDepths[i];
+        const auto& PreviousLodDepth = InPreviousParams.LodDepths[i];
+
+        bResolutionsChanged |= LodDepth.LODResolution != PreviousLodDepth.LODResolution;
+        bRingsChanged |= LodDepth.LODDistance != PreviousLodDepth.LODDistance
+            || LodDepth.bLODSpawnFolaige != PreviousLodDepth.bLODSpawnFolaige
+            || LodDepth.CollisionPolicy != PreviousLodDepth.CollisionPolicy;
+    }
+
+    if (bResolutionsChanged || ChunkCacheSignature != InPreviousSignature)
+    {
+        Changes |= ELandscapeParamChange::Geometry;
+    }
+    if (bResolutionsChanged || bRingsChanged)
+    {
+        Changes |= ELandscapeParamChange::LOD;
+    }
+    return Changes;
+}
+
+// Rebuilds only what InChanges touched, Sections stay on the components they have so the editor keeps showing
+// the old terrain until each rebuilt section lands instead of going blank for a full regeneration.
+void ALandscapeCore::ApplyParamChanges(ELandscapeParamChange InChanges)
 {
-    TArray<FChunkLocation> FoliageKeys;
-    FoliageSections.GetKeys(FoliageKeys);
+    if (EnumHasAnyFlags(InChanges, ELandscapeParamChange::Layout))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Landscape Dirty : Section scale changed, Performing Cleanup and Reinitilatization"));
+        InitializeLODCache();
+        CleanUpLandscape();
+        InitilizeLandscape();
+        return;
+    }
+
+    if (EnumHasAnyFlags(InChanges, ELandscapeParamChange::Geometry))
+    {
+        UE_LOG(LogTemp, Display, TEXT("Landscape Dirty : Regenerating sections in place"));
+        RegenerateSectionsInPlace();
+    }
+    else if (EnumHasAnyFlags(InChanges, ELandscapeParamChange::LOD))
+    {
+        UE_LOG(LogTemp, Display, TEXT("Landscape Dirty : Refreshing section Lod depths"));
+        RefreshSectionLODs();
+        RefreshSectionFoliage();
+        FlushEditorSectionJobs();
+    }
 
-    if (!FoliageKeys.IsEmpty())
+    if (EnumHasAnyFlags(InChanges, ELandscapeParamChange::Material))
     {
-        for (int i = 0; i < FoliageKeys.Num(); i++)
+        UE_LOG(LogTemp, Display, TEXT("Landscape Dirty : Re-binding terrain material"));
+        RebindSectionMaterials();
+    }
+}
+
+// Sets the terrain material on every section and pooled component, Nothing is rebuilt.
+void ALandscapeCore::RebindSectionMaterials()
+{
+    ChunkTable.ForEach([this](const FIntPoint& InChunk, FLandscapeChunkRecord& InRecord)
         {
-            APCGSectionFoliage* Section = *FoliageSections.Find(FoliageKeys[i]);
-            if (Section)
+            if (InRecord.SectionMeshComponent)
             {
-                Section->GenerateFoliage();
+                InRecord.SectionMeshComponent->SetMaterial(0, TerrainMaterial);
             }
+        });
+
+    for (URealtimeMeshComponent* PooledComponent : SectionComponentPool)
+    {
+        if (PooledComponent)
+        {
+            PooledComponent->SetMaterial(0, TerrainMaterial);
         }
     }
 }
 
-void ALandscapeCore::CleanUpFoliage()
+// Rebuilds the Lod rings and every viewer window against them, Each window is released and added again so the demand counts stay balanced.
+// Sections that keep their depth are left alone, the rest get an update job, and sections no window covers anymore are queued for removal.
+void ALandscapeCore::RefreshSectionLODs()
 {
-    TArray<FChunkLocation> FoliageKeys;
-    FoliageSections.GetKeys(FoliageKeys);
+    InitializeLODCache();
+
+    TSet<FChunkLocation> RefreshChunks;
+    for (const TPair<TWeakObjectPtr<AActor>, FLandscapeViewerWindow>& Window : ViewerWindows)
+    {
+        ForEachChunkInWindowDifference(Window.Value, nullptr, [&](const FIntPoint& InChunk)
+            {
+                ReleaseSectionDemand(FChunkLocation(InChunk.X, InChunk.Y), Window.Value.bRendersTerrain, RefreshChunks);
+            });
+    }
+    ViewerWindows.Empty();
 
-    if (!FoliageKeys.IsEmpty())
+    if (GetWorld()->IsGameWorld())
+    {
+        AsyncSpawnTick();
+    }
+    else
     {
-        for (int i = 0; i < FoliageKeys.Num(); i++)
+        UpdateLandscape(GetActorLocation(), false);
+    }
+}
+
+// Brings foliage in line with the ring settings for sections that kept their depth, Collision follows on its own
+// since UpdateSectionCollision rebuilds any section whose collision does not match the policy of its depth.
+void ALandscapeCore::RefreshSectionFoliage()
+{
+    ChunkTable.ForEach([this](const FIntPoint& InChunk, FLandscapeChunkRecord& InRecord)
         {
-            APCGSectionFoliage* Section = *FoliageSections.Find(FoliageKeys[i]);
-            if (Section)
+            if (!InRecord.bGenerated || InRecord.HasJobInFlight())
             {
-                Section->CleanUpFoliage();
+                return;
             }
-        }
+
+            if (LODRingTable.ShouldSpawnFoliage(InRecord.CurrentLODDepth))
+            {
+                HandleSectionFoliage(FChunkLocation(InChunk.X, InChunk.Y), true);
+            }
+            else
+            {
+                RemoveSectionFoliage(InRecord);
+            }
+        });
+}
+
+// Rebuilds every section from the new params on the component it already has, After resetting the shared generation state
+// (biome blender, point cache, disk cache, baked archive, heightfield store) the old params were baked into.
+// In flight spawns are cancelled and queue themselves again, Every other section gets an update job at its demanded depth.
+void ALandscapeCore::RegenerateSectionsInPlace()
+{
+    InitializeGenerationState(GetActorLocation());
+    RefreshSectionLODs();
+
+    ChunkTable.ForEach([this](const FIntPoint& InChunk, FLandscapeChunkRecord& InRecord)
+        {
+            FChunkLocation SectionLocation(InChunk.X, InChunk.Y);
+            const FSectionDemand* Demand = SectionDemands.Find(SectionLocation);
+            if (!InRecord.bGenerated || !Demand || Demand->ViewerCount == 0)
+            {
+                return;
+            }
+
+            if (InRecord.JobToken && !InRecord.JobToken->IsUpdate())
+            {
+                CancelSectionJob(SectionLocation, false);
+                return;
+            }
+
+            // Foliage was placed on the old heights, The update commit places it again.
+            RemoveSectionFoliage(InRecord);
+            ChunkScheduler.Enqueue(InChunk, Demand->LODDepth, true);
+        });
+
+    FlushEditorSectionJobs();
+}
+
+// Foliage actors and instances of a section that stays generated.
+void ALandscapeCore::RemoveSectionFoliage(FLandscapeChunkRecord& InChunkRecord)
+{
+    RemoveSectionFoliageInstances(InChunkRecord);
+    if (APCGSectionFoliage* FoliageSection = InChunkRecord.FoliageSection.Get())
+    {
+        FoliageSection->CleanUpFoliage();
+        FoliageSection->Destroy();
+    }
+    InChunkRecord.FoliageSection = nullptr;
+}
+
+// Nothing ticks outside of game worlds, So queued removals and jobs are handed out here instead of waiting for Tick.
+void ALandscapeCore::FlushEditorSectionJobs()
+{
+    if (GetWorld()->IsGameWorld())
+    {
+        return;
     }
+    RemoveSections();
+    DispatchScheduledSections(MAX_int32, MAX_int32);
+}
+
+void ALandscapeCore::GenerateFoliage()
+{
+    ChunkTable.ForEach([](const FIntPoint& InChunk, FLandscapeChunkRecord& InRecord)
+        {
+            if (APCGSectionFoliage* Section = InRecord.FoliageSection.Get())
+            {
+                Section->GenerateFoliage();
+            }
+        });
+}
+
+void ALandscapeCore::CleanUpFoliage()
+{
+    ChunkTable.ForEach([](const FIntPoint& InChunk, FLandscapeChunkRecord& InRecord)
+        {
+            if (APCGSectionFoliage* Section = InRecord.FoliageSection.Get())
+            {
+                Section->CleanUpFoliage();
+            }
+        });
 }
 
 void ALandscapeCore::CleanLandscape()
@@ -109,331 +582,1872 @@ void ALandscapeCore::Tick(float DeltaTime)
     if (!bIsInitialized)
         return;
 
-    if (CurrentTick >= UpdateInterval)
+    // Completed sections are committed and new jobs dispatched every frame so streaming stays steady between landscape updates.
+    DrainCommitQueue();
+    DispatchScheduledSections(SectionDispatchesPerTick, MaxConcurrentSectionJobs);
+
+    // Streaming updates run on a fixed period in seconds so the cadence is the same at any frame or server tick rate,
+    // Timed on the real frame time, The game DeltaTime is dilated and clamped and says nothing about how loaded the machine is.
+    float FrameSeconds = float(FApp::GetDeltaTime());
+    if (bAdaptiveUpdateInterval)
+    {
+        UpdateAdaptiveInterval(FrameSeconds);
+    }
+    else
+    {
+        CurrentUpdateInterval = FMath::Max(UpdateIntervalSeconds, 0.0f);
+    }
+
+    // The interval is taken off rather than resetting so the overshoot carries over and the cadence does not drift,
+    // After a hitch at most one interval is carried so updates do not run back to back to catch up.
+    TimeSinceStreamingUpdate += FrameSeconds;
+    if (TimeSinceStreamingUpdate >= CurrentUpdateInterval)
     {
         AsyncSpawnTick();
-        CurrentTick = 0;
+        TimeSinceStreamingUpdate = FMath::Min(TimeSinceStreamingUpdate - CurrentUpdateInterval, CurrentUpdateInterval);
     }
+}
+
+// Moves the streaming interval between MinUpdateIntervalSeconds and MaxUpdateIntervalSeconds from the smoothed frame time,
+// Doubling it for every second frames run over TargetFrameMilliseconds and halving it every two seconds there is headroom,
+// so a single hitch does not make streaming thrash and a loaded server backs off on its own.
+void ALandscapeCore::UpdateAdaptiveInterval(float InFrameSeconds)
+{
+    float FrameMilliseconds = InFrameSeconds * 1000.0f;
+    SmoothedFrameMilliseconds = SmoothedFrameMilliseconds > 0.0f ? FMath::Lerp(SmoothedFrameMilliseconds, FrameMilliseconds, 0.1f) : FrameMilliseconds;
 
-    CurrentTick++;
+    float MinInterval = FMath::Max(MinUpdateIntervalSeconds, 0.0f);
+    float MaxInterval = FMath::Max(MaxUpdateIntervalSeconds, MinInterval);
+    float NewInterval = FMath::Max(CurrentUpdateInterval, KINDA_SMALL_NUMBER);
+
+    if (SmoothedFrameMilliseconds > TargetFrameMilliseconds * 1.1f)
+    {
+        NewInterval *= FMath::Pow(2.0f, InFrameSeconds);
+    }
+    else if (SmoothedFrameMilliseconds < TargetFrameMilliseconds * 0.8f)
+    {
+        NewInterval *= FMath::Pow(0.5f, InFrameSeconds * 0.5f);
+    }
+    CurrentUpdateInterval = FMath::Clamp(NewInterval, MinInterval, MaxInterval);
 }
 
 void ALandscapeCore::InitilizeLandscape()
 {
     FVector RootLocation = this->GetActorLocation();
-    
-    BiomeBlender = MakeShared<ScatteredBiomeBlender>();
-    BiomeBlender->Initialize(LandscapeNoiseParams.BiomeGenerationData.PointFrequency, LandscapeNoiseParams.BiomeGenerationData.BlendRadiusPadding, SectionScale);
 
-    UpdateLandscape(RootLocation, true);
-    bIsInitialized = true;
-}
+    // Room for the generation distance and prefetch look ahead on both sides, plus the row still waiting on removal.
+    ChunkTable.Reset(2 * (GetGenerationDisantance() + MaxPrefetchChunks) + 2);
+    NumSectionJobsInFlight = 0;
 
-void ALandscapeCore::AsyncSpawnTick()
-{
-    FVector PlayerLocation = UGameplayStatics::GetPlayerPawn(GetWorld(), 0)->GetActorLocation();
+    InitializeGenerationState(RootLocation);
+    ConfigureEditLayer();
 
-    if (!ActiveGenerationDataMap.IsEmpty())
-        return;
+    CurrentUpdateInterval = FMath::Max(UpdateIntervalSeconds, 0.0f);
+    TimeSinceStreamingUpdate = 0.0f;
+    SmoothedFrameMilliseconds = 0.0f;
 
-    UpdateLandscape(PlayerLocation, false);
-    ProcessFoliageQueue();
+    PrewarmSectionPool();
+    UpdateLandscape(RootLocation, true);
+    bIsInitialized = true;
 }
 
-
-// Normalizes Location in world space to the root component of the landscape,  
-// Handles Spawn, update, and removal of sections based upon current normalized location in realtion to the grid, 
-// Tracks the currently occupyed section and all sections within the generation distance.
-// Removes sections found to be outside of the Generation Distance,
-// Spawns sections that are not found in the generated sections set if they are within generation distance,
-// Updates sections based upon generation distance per Lod depth, If a generated sections lod depth is not alligned with the Lod cashe for its index then the section is updated.
-void ALandscapeCore::UpdateLandscape(FVector InLocation, bool Initilization)
+// Everything section jobs share that depends on the generation params, Rebuilt on initilization and whenever the geometry params change.
+void ALandscapeCore::InitializeGenerationState(const FVector& InRootLocation)
 {
-   
-    FVector RootLocation = this->GetActorLocation();
-    FVector NormalizedtLocation;
-
-    NormalizedtLocation = InLocation - RootLocation;
+    BiomeBlender = MakeShared<ScatteredBiomeBlender>();
+    BiomeBlender->Initialize(LandscapeNoiseParams.BiomeGenerationData.PointFrequency, LandscapeNoiseParams.BiomeGenerationData.BlendRadiusPadding, SectionScale);
 
-    FChunkLocation ActiveSection = FChunkLocation(FMath::TruncToInt32(NormalizedtLocation.X / SectionScale), FMath::TruncToInt32(NormalizedtLocation.Y / SectionScale));
+    // Section jobs share one point cache so neighbouring chunks reuse the scattered points around them instead of recomputing them,
+    // The points and blend radius come from the blender so cached weights match the ones it blends sections with.
+    BiomePointCache = MakeShared<FLandscapeBiomePointCache, ESPMode::ThreadSafe>(
+        BiomeBlender->GetBlendRadius(),
+        SectionScale,
+        LandscapeNoiseParams.BiomeGenerationData.Biomes.Num(),
+        [Blender = BiomeBlender](const FVector2D& InMin, const FVector2D& InMax, TArray<FVector2D>& OutLocations)
+        {
+            Blender->GatherPoints(InMin, InMax, OutLocations);
+        },
+        [NoiseParams = LandscapeNoiseParams](double InX, double InY)
+        {
+            return NoiseParams.GetBiomeIndexAt(InX, InY);
+        });
 
-    if (ActiveSection == CurrentChunk && !Initilization)
+    ChunkCache = nullptr;
+    if (bUseChunkDiskCache)
     {
-        if (RenderedSections.Num() < GeneratedChunks.Num())
-        {
-            RemoveSections();
-        }
-        return;
+        ChunkCache = MakeShared<FLandscapeChunkCache, ESPMode::ThreadSafe>(FPaths::ProjectSavedDir() / TEXT("TerrainCache"), ChunkCacheSignature);
+        ChunkCache->TrimStaleSignatures();
     }
 
-    CurrentChunk = ActiveSection;
-    int32 GenerationDistance = GetGenerationDisantance();
-    RenderedSections.Empty();
-    RenderedSections.Add(CurrentChunk);
-
-    if (GEngine && !Initilization)
+    // Baked tiles replace generation inside the baked rectangle, Chunks outside it and resolutions that were not baked stay procedural.
+    BakedArchive = nullptr;
+    if (bUseBakedTerrain && !BakedTerrainPath.IsEmpty())
     {
-        int32 XLocationtest = CurrentChunk.XLocation;
-        int32 YLocationtest = CurrentChunk.YLocation;
-        FString Message = FString::Printf(TEXT("Current Player Section location : X=%d, Y=%d"), XLocationtest, YLocationtest);
-        GEngine->AddOnScreenDebugMessage(-1, 10.f, FColor::Green, Message);
+        BakedArchive = FLandscapeBakedArchive::Open(FPaths::ProjectContentDir() / BakedTerrainPath, ChunkCacheSignature);
     }
-
-    for (int32 XChunkIndex = GenerationDistance * -1; XChunkIndex <= GenerationDistance; XChunkIndex++)
+    else if (bUseBakedTerrain)
     {
-        for (int32 YChunkIndex = GenerationDistance * -1; YChunkIndex <= GenerationDistance; YChunkIndex++)
-        {
-            VisibleChunk = FChunkLocation(CurrentChunk.XLocation + XChunkIndex, CurrentChunk.YLocation + YChunkIndex);
-            FVector Location((VisibleChunk.XLocation) * SectionScale, (VisibleChunk.YLocation) * SectionScale, RootLocation.Z);
+        UE_LOG(LogTemp, Warning, TEXT("Landscape Streaming : bUseBakedTerrain is set without a BakedTerrainPath, Falling back to procedural generation"));
+    }
 
-            int32 AbsXChunkIndex = abs(XChunkIndex);
-            int32 AbsYChunkIndex = abs(YChunkIndex);
-            RenderedSections.Add(VisibleChunk);
+    // The store outlives clean ups so queries from other threads never see it swapped out, Reset drops every tile of the last run.
+    if (!HeightfieldStore)
+    {
+        HeightfieldStore = MakeShared<FLandscapeHeightfieldStore, ESPMode::ThreadSafe>();
+    }
+    HeightfieldStore->Reset(InRootLocation, SectionScale);
+}
 
-            if (!GeneratedChunks.Contains(VisibleChunk))
+void ALandscapeCore::AsyncSpawnTick()
+{
+    TArray<FLandscapeStreamingViewer> Viewers;
+    GatherStreamingViewers(Viewers);
+
+    // Nothing to stream around yet (no pawn possessed, or a server with no players connected).
+    if (Viewers.IsEmpty())
+    {
+        return;
+    }
+
+    UpdateStreamingSections(Viewers, false);
+    UpdateSectionCollision(Viewers);
+
+    AActor* PrimaryViewer = Viewers[0].Actor.Get();
+    APawn* PrimaryPawn = Cast<APawn>(PrimaryViewer);
+    FRotator ViewRotation = PrimaryPawn ? PrimaryPawn->GetControlRotation() : PrimaryViewer->GetActorRotation();
+    ChunkScheduler.SetFocus(FIntPoint(CurrentChunk.XLocation, CurrentChunk.YLocation), FVector2D(ViewRotation.Vector()));
+
+    if (bPrefetchSections)
+    {
+        PrefetchSections(Viewers);
+    }
+}
+
+
+// Streaming Viewers
+
+// Adds an actor the landscape streams terrain around, Registering an actor again replaces its settings.
+// While no viewer is registered the landscape streams around player 0 as before.
+void ALandscapeCore::RegisterStreamingViewer(AActor* InViewer, int32 InGenerationDistance, int32 InLODBias, bool bInRendersTerrain)
+{
+    if (!IsValid(InViewer))
+    {
+        return;
+    }
+
+    FLandscapeStreamingViewer* ExistingViewer = StreamingViewers.FindByPredicate([InViewer](const FLandscapeStreamingViewer& Viewer)
+        {
+            return Viewer.Actor == InViewer;
+        });
+
+    if (ExistingViewer)
+    {
+        *ExistingViewer = FLandscapeStreamingViewer(InViewer, InGenerationDistance, InLODBias, bInRendersTerrain);
+    }
+    else
+    {
+        StreamingViewers.Add(FLandscapeStreamingViewer(InViewer, InGenerationDistance, InLODBias, bInRendersTerrain));
+    }
+}
+
+void ALandscapeCore::UnregisterStreamingViewer(AActor* InViewer)
+{
+    StreamingViewers.RemoveAll([InViewer](const FLandscapeStreamingViewer& Viewer) { return Viewer.Actor == InViewer; });
+}
+
+// Resolves every live viewer to the chunk it is standing in, Rendering viewers first so the primary viewer is the local one whenever there is one.
+void ALandscapeCore::GatherStreamingViewers(TArray<FLandscapeStreamingViewer>& OutViewers)
+{
+    StreamingViewers.RemoveAll([](const FLandscapeStreamingViewer& Viewer) { return !Viewer.Actor.IsValid(); });
+
+    OutViewers = StreamingViewers;
+
+    if (OutViewers.IsEmpty())
+    {
+        if (APawn* PlayerPawn = UGameplayStatics::GetPlayerPawn(GetWorld(), 0))
+        {
+            OutViewers.Add(FLandscapeStreamingViewer(PlayerPawn, 0, 0, true));
+        }
+    }
+
+    for (FLandscapeStreamingViewer& Viewer : OutViewers)
+    {
+        AActor* ViewerActor = Viewer.Actor.Get();
+        FChunkLocation ViewerChunk = GetChunkForLocation(ViewerActor->GetActorLocation());
+        Viewer.Chunk = FIntPoint(ViewerChunk.XLocation, ViewerChunk.YLocation);
+        Viewer.Velocity = ViewerActor->GetVelocity();
+    }
+
+    OutViewers.StableSort([](const FLandscapeStreamingViewer& A, const FLandscapeStreamingViewer& B)
+        {
+            return A.bRendersTerrain && !B.bRendersTerrain;
+        });
+}
+
+// Hides sections only non rendering viewers need, Collision stays enabled either way.
+void ALandscapeCore::UpdateSectionVisibility(const FChunkLocation& InSectionLocation)
+{
+    if (FLandscapeChunkRecord* ChunkRecord = FindChunkRecord(InSectionLocation))
+    {
+        if (ChunkRecord->SectionMeshComponent)
+        {
+            ChunkRecord->SectionMeshComponent->SetVisibility(IsSectionRendered(InSectionLocation));
+        }
+    }
+}
+
+bool ALandscapeCore::IsSectionRendered(const FChunkLocation& InSectionLocation) const
+{
+    const FSectionDemand* Demand = SectionDemands.Find(InSectionLocation);
+    return !Demand || Demand->RenderViewerCount > 0;
+}
+
+// Hands the highest priority pending jobs from the scheduler to the worker threads, 
+// Keeps at most InMaxInFlight section jobs running at once.
+// A chunk that still has a job in flight keeps its new job in the scheduler until the running one is committed,
+// A running Lod update is cancelled so the newer request is not left waiting on stale work.
+// Prefetch jobs come out last and are only dispatched while fewer than MaxPrefetchJobsInFlight jobs are running.
+void ALandscapeCore::DispatchScheduledSections(int32 InMaxDispatches, int32 InMaxInFlight)
+{
+    LANDSCAPE_SCOPE(STAT_LandscapeDispatch);
+
+    FPendingChunkJob Job;
+    TArray<FPendingChunkJob> DeferredJobs;
+    int32 Dispatched = 0;
+
+    while (Dispatched < InMaxDispatches && NumSectionJobsInFlight < InMaxInFlight && ChunkScheduler.Dequeue(Job))
+    {
+        FChunkLocation JobChunk = FChunkLocation(Job.Chunk.X, Job.Chunk.Y);
+        FVector Location(JobChunk.XLocation * SectionScale, JobChunk.YLocation * SectionScale, GetActorLocation().Z);
+
+        if (Job.bIsPrefetch && NumSectionJobsInFlight >= MaxPrefetchJobsInFlight)
+        {
+            DeferredJobs.Add(Job);
+            break;
+        }
+
+        const FLandscapeChunkRecord* ChunkRecord = FindChunkRecord(JobChunk);
+
+        // The scheduler keeps a spawn when an update is merged into it, So a spawn can reach a section that has been generated since.
+        // It carries the newest Lod depth and is dispatched as an update, or dropped (not counted, telemetry untouched) if the section is already there.
+        if (!Job.bIsUpdate && ChunkRecord && ChunkRecord->bGenerated)
+        {
+            if (!ChunkRecord->HasJobInFlight() && ChunkRecord->CurrentLODDepth == Job.LODDepth)
+            {
+                continue;
+            }
+            Job.bIsUpdate = true;
+        }
+
+        if (ChunkRecord && ChunkRecord->HasJobInFlight())
+        {
+            if (Job.bIsUpdate)
+            {
+                CancelSectionJob(JobChunk, true);
+            }
+            DeferredJobs.Add(Job);
+            continue;
+        }
+
+        if (Job.bIsUpdate)
+        {
+            AsyncUpdateSection(JobChunk, Location, Job.LODDepth);
+        }
+        else
+        {
+            AsyncSpawnSection(JobChunk, Location, Job.LODDepth);
+        }
+        Dispatched++;
+
+        // Read back by the commit for the streaming telemetry.
+        if (FLandscapeChunkRecord* DispatchedRecord = FindChunkRecord(JobChunk))
+        {
+            DispatchedRecord->RequestTime = Job.RequestTime;
+            DispatchedRecord->DispatchTime = FPlatformTime::Seconds();
+        }
+    }
+
+    for (const FPendingChunkJob& DeferredJob : DeferredJobs)
+    {
+        ChunkScheduler.Requeue(DeferredJob);
+    }
+}
+
+// Creates the token for a new job on the section, cancelling any job the section already had.
+FSectionJobTokenPtr ALandscapeCore::IssueSectionJobToken(const FChunkLocation& InSectionLocation, bool bIsUpdate)
+{
+    CancelSectionJob(InSectionLocation, false);
+
+    FSectionJobTokenPtr JobToken = MakeShared<FSectionJobToken, ESPMode::ThreadSafe>(++NextJobGeneration, bIsUpdate);
+    FindOrAddChunkRecord(InSectionLocation).JobToken = JobToken;
+    return JobToken;
+}
+
+void ALandscapeCore::CancelSectionJob(const FChunkLocation& InSectionLocation, bool bUpdatesOnly)
+{
+    FLandscapeChunkRecord* ChunkRecord = FindChunkRecord(InSectionLocation);
+    if (ChunkRecord && ChunkRecord->JobToken)
+    {
+        if (!bUpdatesOnly || ChunkRecord->JobToken->IsUpdate())
+        {
+            ChunkRecord->JobToken->Cancel();
+        }
+    }
+}
+
+// Called from the worker thread once a section has been built or has stopped early after being cancelled.
+// In game worlds the result waits in the commit queue for Tick, Outside of game worlds (editor construction) nothing ticks so it is committed straight away.
+void ALandscapeCore::QueueSectionCommit(const FChunkLocation& InSectionLocation, const FSectionJobTokenPtr& InJobToken, bool bSpawnFoliage, bool bCommitImmediately, float InBuildMilliseconds)
+{
+    // Counted before the result is visible, So the game thread never sees a result the count does not include.
+    NumQueuedCommits++;
+    CompletedSectionQueue.Enqueue(FCompletedSectionJob(
+        FIntPoint(InSectionLocation.XLocation, InSectionLocation.YLocation),
+        InJobToken->GetGeneration(),
+        InJobToken->IsUpdate(),
+        bSpawnFoliage,
+        InJobToken->IsCancelled(),
+        InBuildMilliseconds));
+
+    if (bCommitImmediately)
+    {
+        AsyncTask(ENamedThreads::GameThread, [this]()
+            {
+                CommitCompletedSections(MAX_int32, MAX_dbl);
+
+                // Jobs that were deferred behind the one just committed.
+                DispatchScheduledSections(MAX_int32, MAX_int32);
+            });
+    }
+}
+
+// The game thread commit stage, Runs every Tick and stops once CommitBudgetMilliseconds is spent,
+// so a burst of completions is spread over several frames instead of landing in one.
+// Section commits (edge stitching, foliage requests, bookkeeping) go first, then foliage actors are spawned from what is left.
+// At least one of each is processed per frame so neither queue can stall behind a budget that is too small.
+void ALandscapeCore::DrainCommitQueue()
+{
+    double StartTime = FPlatformTime::Seconds();
+    double Deadline = StartTime + FMath::Max(CommitBudgetMilliseconds, 0.0f) * 0.001;
+
+    CommitStats.SectionsCommitted = CommitCompletedSections(MaxSectionCommitsPerTick, Deadline);
+    CommitStats.FoliageSpawned = ProcessFoliageQueue(Deadline);
+
+    CommitStats.CommitMilliseconds = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+    CommitStats.PeakCommitMilliseconds = FMath::Max(CommitStats.PeakCommitMilliseconds, CommitStats.CommitMilliseconds);
+    CommitStats.QueueDepth = NumQueuedCommits.load();
+    CommitStats.FoliageQueueDepth = NumQueuedFoliageSpawns.load();
+
+    StreamingTelemetry.UpdateGauges(NumSectionJobsInFlight, ChunkScheduler.Num(), CommitStats.QueueDepth, HeightfieldStore ? HeightfieldStore->Num() : 0);
+
+    if (CVarLandscapeShowCommitStats.GetValueOnGameThread() && GEngine)
+    {
+        FString Message = FString::Printf(TEXT("Landscape Commit : %.2f ms (peak %.2f ms), Committed %d, Queued %d, Foliage spawned %d, Foliage queued %d"),
+            CommitStats.CommitMilliseconds, CommitStats.PeakCommitMilliseconds, CommitStats.SectionsCommitted, CommitStats.QueueDepth,
+            CommitStats.FoliageSpawned, CommitStats.FoliageQueueDepth);
+        GEngine->AddOnScreenDebugMessage(uint64(GetUniqueID()), 0.0f, FColor::Cyan, Message);
+    }
+}
+
+// Applies finished section jobs on the game thread, At most InMaxCommits are processed per call and none are started after InDeadline
+// (apart from the first), Returns the number of results taken off the queue.
+int32 ALandscapeCore::CommitCompletedSections(int32 InMaxCommits, double InDeadline)
+{
+    LANDSCAPE_SCOPE(STAT_LandscapeCommit);
+
+    FCompletedSectionJob CompletedJob;
+    int32 Committed = 0;
+
+    while (Committed < InMaxCommits && (Committed == 0 || FPlatformTime::Seconds() < InDeadline) && CompletedSectionQueue.Dequeue(CompletedJob))
+    {
+        FChunkLocation SectionLocation = FChunkLocation(CompletedJob.Chunk.X, CompletedJob.Chunk.Y);
+        Committed++;
+        NumQueuedCommits--;
+
+        // Results from jobs issued before the landscape was cleaned up no longer own anything.
+        FLandscapeChunkRecord* ChunkRecord = FindChunkRecord(SectionLocation);
+        if (!ChunkRecord || !ChunkRecord->JobToken || ChunkRecord->JobToken->GetGeneration() != CompletedJob.Generation)
+        {
+            continue;
+        }
+
+        ChunkRecord->JobToken = nullptr;
+        ChunkRecord->GenerationData = nullptr;
+        NumSectionJobsInFlight--;
+
+        if (CompletedJob.bCancelled)
+        {
+            StreamingTelemetry.RecordCancelled();
+
+            // A cancelled spawn left an empty component behind, If the player came back before it was removed the section is queued again.
+            if (!CompletedJob.bIsUpdate && ChunkRecord->bGenerated)
+            {
+                int32 SectionLODDepth = ChunkRecord->CurrentLODDepth;
+                if (ChunkRecord->SectionMeshComponent)
+                {
+                    ReleaseSectionComponent(ChunkRecord->SectionMeshComponent, SectionLocation);
+                }
+                RemoveChunkRecord(SectionLocation);
+                RemoveSectionHeightfield(SectionLocation);
+
+                if (RenderedSections.Contains(SectionLocation))
+                {
+                    ChunkScheduler.Enqueue(CompletedJob.Chunk, SectionLODDepth, false);
+                }
+            }
+            else if (CompletedJob.bIsUpdate && ChunkRecord->bGenerated)
+            {
+                // A cancelled update left the previous mesh in place, The record goes back to its depth and the update is queued again while the section is still wanted,
+                // Updates that rebuild at the same depth (param or edit changes) are queued again as well so their change is not lost.
+                ChunkRecord->CurrentLODDepth = ChunkRecord->PreviousLODDepth;
+
+                const FSectionDemand* Demand = SectionDemands.Find(SectionLocation);
+                if (Demand && RenderedSections.Contains(SectionLocation))
+                {
+                    ChunkScheduler.Enqueue(CompletedJob.Chunk, Demand->LODDepth, true);
+                }
+            }
+            continue;
+        }
+
+        if (!ChunkRecord->bGenerated)
+        {
+            continue;
+        }
+
+        FLandscapeChunkTiming Timing;
+        Timing.Chunk = CompletedJob.Chunk;
+        Timing.LODDepth = ChunkRecord->CurrentLODDepth;
+        Timing.bIsUpdate = CompletedJob.bIsUpdate;
+        Timing.CommitTime = FPlatformTime::Seconds();
+        Timing.QueueMilliseconds = float((ChunkRecord->DispatchTime - ChunkRecord->RequestTime) * 1000.0);
+        Timing.BuildMilliseconds = CompletedJob.BuildMilliseconds;
+        Timing.TimeToVisibleMilliseconds = float((Timing.CommitTime - ChunkRecord->RequestTime) * 1000.0);
+        StreamingTelemetry.RecordCommit(Timing);
+
+        if (bStitchSectionEdges && bUseLODs)
+        {
+            CaptureSectionEdges(SectionLocation, GetSectionResolution(ChunkRecord->CurrentLODDepth));
+            RestitchSectionEdges(SectionLocation);
+        }
+
+        if (PriorityCollisionChunks.Contains(SectionLocation))
+        {
+            RefreshSectionCollision(SectionLocation, *ChunkRecord);
+        }
+        else if (CollisionDemand.Contains(SectionLocation))
+        {
+            PendingCollisionChunks.Add(SectionLocation);
+        }
+
+        if (CompletedJob.bSpawnFoliage)
+        {
+            HandleSectionFoliage(SectionLocation, CompletedJob.bIsUpdate);
+        }
+    }
+    return Committed;
+}
+
+
+// Streams around a single viewer at InLocation, Used on initilization and in the editor where there are no streaming viewers.
+void ALandscapeCore::UpdateLandscape(FVector InLocation, bool Initilization)
+{
+    FChunkLocation ActiveSection = GetChunkForLocation(InLocation);
+
+    TArray<FLandscapeStreamingViewer> Viewers;
+    FLandscapeStreamingViewer& Viewer = Viewers.AddDefaulted_GetRef();
+    Viewer.Chunk = FIntPoint(ActiveSection.XLocation, ActiveSection.YLocation);
+
+    UpdateStreamingSections(Viewers, Initilization);
+}
+
+// Handles Spawn, update, and removal of sections based upon the chunks every viewer currently occupies,
+// The required sections are the union of every viewers generation distance, A chunk covered by several viewers is only generated once
+// at the finest Lod depth any of them asks for, and is only removed once no viewer covers it anymore.
+// The union is kept up to date incrementally, When a viewer moves only the strips entering and leaving its window are visited,
+// plus the chunks crossing a Lod ring boundary, so the cost follows the number of changed chunks rather than the window size.
+// Sections leaving every window are queued in PendingRemovals and drained on every update, moving or not, so a viewer that never stops
+// does not keep a trail of sections behind it.
+// Queued jobs are dispatched by the chunk scheduler closest to any viewer first, On initilization every job is dispatched immediately.
+void ALandscapeCore::UpdateStreamingSections(const TArray<FLandscapeStreamingViewer>& InViewers, bool Initilization)
+{
+    LANDSCAPE_SCOPE(STAT_LandscapeUpdateStreaming);
+
+    TMap<TWeakObjectPtr<AActor>, FLandscapeViewerWindow> NewWindows;
+    TArray<FIntPoint> SecondaryFocusChunks;
+    for (const FLandscapeStreamingViewer& Viewer : InViewers)
+    {
+        int32 GenerationDistance = Viewer.GenerationDistance > 0 ? Viewer.GenerationDistance : GetGenerationDisantance();
+        NewWindows.Add(Viewer.Actor, FLandscapeViewerWindow(Viewer.Chunk, GenerationDistance, Viewer.LODBias, Viewer.bRendersTerrain));
+        if (&Viewer != &InViewers[0])
+        {
+            SecondaryFocusChunks.Add(Viewer.Chunk);
+        }
+    }
+
+    if (!Initilization && NewWindows.OrderIndependentCompareEqual(ViewerWindows))
+    {
+        if (!PendingRemovals.IsEmpty())
+        {
+            RemoveSections();
+        }
+        return;
+    }
+
+    FChunkLocation PrimaryChunk = FChunkLocation(InViewers[0].Chunk.X, InViewers[0].Chunk.Y);
+    if (GEngine && !Initilization && !(PrimaryChunk == CurrentChunk))
+    {
+        FString Message = FString::Printf(TEXT("Current Player Section location : X=%d, Y=%d"), PrimaryChunk.XLocation, PrimaryChunk.YLocation);
+        GEngine->AddOnScreenDebugMessage(-1, 10.f, FColor::Green, Message);
+    }
+
+    CurrentChunk = PrimaryChunk;
+    ChunkScheduler.SetFocus(InViewers[0].Chunk, FVector2D::ZeroVector);
+    ChunkScheduler.SetSecondaryFocus(SecondaryFocusChunks);
+
+    TMap<TWeakObjectPtr<AActor>, FLandscapeViewerWindow> OldWindows = MoveTemp(ViewerWindows);
+    ViewerWindows = MoveTemp(NewWindows);
+
+    // Chunks whose demanded Lod depth or visibility may have changed.
+    TSet<FChunkLocation> RefreshChunks;
+
+    // A viewer that changed anything but its chunk is treated as leaving and coming back so its counts stay balanced.
+    auto KeepsSettings = [](const FLandscapeViewerWindow* InOldWindow, const FLandscapeViewerWindow* InNewWindow)
+        {
+            return InOldWindow && InNewWindow && InOldWindow->Radius == InNewWindow->Radius && InOldWindow->LODBias == InNewWindow->LODBias && InOldWindow->bRendersTerrain == InNewWindow->bRendersTerrain;
+        };
+
+    for (const TPair<TWeakObjectPtr<AActor>, FLandscapeViewerWindow>& OldWindow : OldWindows)
+    {
+        const FLandscapeViewerWindow* NewWindow = ViewerWindows.Find(OldWindow.Key);
+        ForEachChunkInWindowDifference(OldWindow.Value, KeepsSettings(&OldWindow.Value, NewWindow) ? NewWindow : nullptr, [&](const FIntPoint& InChunk)
+            {
+                ReleaseSectionDemand(FChunkLocation(InChunk.X, InChunk.Y), OldWindow.Value.bRendersTerrain, RefreshChunks);
+            });
+    }
+
+    for (const TPair<TWeakObjectPtr<AActor>, FLandscapeViewerWindow>& NewWindow : ViewerWindows)
+    {
+        const FLandscapeViewerWindow* OldWindow = OldWindows.Find(NewWindow.Key);
+        bool bKeepsSettings = KeepsSettings(OldWindow, &NewWindow.Value);
+        ForEachChunkInWindowDifference(NewWindow.Value, bKeepsSettings ? OldWindow : nullptr, [&](const FIntPoint& InChunk)
+            {
+                AddSectionDemand(FChunkLocation(InChunk.X, InChunk.Y), NewWindow.Value.bRendersTerrain);
+                RefreshChunks.Add(FChunkLocation(InChunk.X, InChunk.Y));
+            });
+
+        if (bKeepsSettings && bUseLODs && !LodDepths.IsEmpty())
+        {
+            AddLODRingRefreshChunks(*OldWindow, NewWindow.Value, RefreshChunks);
+        }
+    }
+
+    for (const FChunkLocation& RefreshChunk : RefreshChunks)
+    {
+        FSectionDemand* Demand = SectionDemands.Find(RefreshChunk);
+        if (!Demand)
+        {
+            continue;
+        }
+
+        Demand->LODDepth = ComputeDemandLOD(RefreshChunk);
+        FIntPoint SchedulerChunk(RefreshChunk.XLocation, RefreshChunk.YLocation);
+
+        const FLandscapeChunkRecord* ChunkRecord = FindChunkRecord(RefreshChunk);
+        if (!ChunkRecord || !ChunkRecord->bGenerated)
+        {
+            ChunkScheduler.Enqueue(SchedulerChunk, Demand->LODDepth, false);
+        }
+        else
+        {
+            if (!Initilization && bUseLODs && !LodDepths.IsEmpty() && ChunkRecord->CurrentLODDepth != Demand->LODDepth)
+            {
+                ChunkScheduler.Enqueue(SchedulerChunk, Demand->LODDepth, true);
+            }
+            UpdateSectionVisibility(RefreshChunk);
+        }
+    }
+
+    // Chunks that came back into a window this update were taken off PendingRemovals by AddSectionDemand, So only chunks no viewer covers are left.
+    if (!PendingRemovals.IsEmpty())
+    {
+        RemoveSections();
+    }
+
+    if (Initilization)
+    {
+        DispatchScheduledSections(MAX_int32, MAX_int32);
+    }
+}
+
+void ALandscapeCore::AddSectionDemand(const FChunkLocation& InSectionLocation, bool bRendersTerrain)
+{
+    FSectionDemand& Demand = SectionDemands.FindOrAdd(InSectionLocation);
+    if (Demand.ViewerCount == 0)
+    {
+        RenderedSections.Add(InSectionLocation);
+        PendingRemovals.Remove(InSectionLocation);
+    }
+
+    Demand.ViewerCount++;
+    Demand.RenderViewerCount += bRendersTerrain ? 1 : 0;
+}
+
+// Drops one viewers claim on the chunk, Once no viewer covers it any pending job is dropped and a generated section is queued for removal.
+void ALandscapeCore::ReleaseSectionDemand(const FChunkLocation& InSectionLocation, bool bRendersTerrain, TSet<FChunkLocation>& OutRefreshChunks)
+{
+    FSectionDemand* Demand = SectionDemands.Find(InSectionLocation);
+    if (!Demand)
+    {
+        return;
+    }
+
+    Demand->ViewerCount--;
+    Demand->RenderViewerCount -= bRendersTerrain ? 1 : 0;
+
+    if (Demand->ViewerCount > 0)
+    {
+        OutRefreshChunks.Add(InSectionLocation);
+        return;
+    }
+
+    SectionDemands.Remove(InSectionLocation);
+    RenderedSections.Remove(InSectionLocation);
+    OutRefreshChunks.Remove(InSectionLocation);
+
+    if (IsChunkGenerated(InSectionLocation))
+    {
+        PendingRemovals.Add(InSectionLocation);
+    }
+    if (!PrefetchedSections.Contains(InSectionLocation))
+    {
+        ChunkScheduler.Remove(FIntPoint(InSectionLocation.XLocation, InSectionLocation.YLocation));
+    }
+}
+
+// Finest Lod depth any viewer covering the chunk asks for.
+int32 ALandscapeCore::ComputeDemandLOD(const FChunkLocation& InSectionLocation)
+{
+    int32 LODDepth = MAX_int32;
+
+    for (const TPair<TWeakObjectPtr<AActor>, FLandscapeViewerWindow>& Window : ViewerWindows)
+    {
+        int32 AbsXChunkIndex = abs(InSectionLocation.XLocation - Window.Value.Center.X);
+        int32 AbsYChunkIndex = abs(InSectionLocation.YLocation - Window.Value.Center.Y);
+        if (AbsXChunkIndex <= Window.Value.Radius && AbsYChunkIndex <= Window.Value.Radius)
+        {
+            LODDepth = FMath::Min(LODDepth, GetViewerLODForIndex(Window.Value.LODBias, AbsXChunkIndex, AbsYChunkIndex));
+        }
+    }
+    return LODDepth == MAX_int32 ? 0 : LODDepth;
+}
+
+// Lod depth only depends on the Chebyshev distance to the viewer, so after moving M chunks a section can only change depth
+// if its new distance lies within M of a ring boundary. Only those shells are added instead of the whole window.
+void ALandscapeCore::AddLODRingRefreshChunks(const FLandscapeViewerWindow& InOldWindow, const FLandscapeViewerWindow& InNewWindow, TSet<FChunkLocation>& OutRefreshChunks)
+{
+    int32 MoveDistance = FMath::Max(abs(InNewWindow.Center.X - InOldWindow.Center.X), abs(InNewWindow.Center.Y - InOldWindow.Center.Y));
+    if (MoveDistance == 0)
+    {
+        return;
+    }
+
+    for (int32 i = 0; i < LODRingTable.Num() - 1; i++)
+    {
+        int32 RingBoundary = LODRingTable.GetOuterDistance(i);
+
+        int32 FirstShell = FMath::Max(RingBoundary - MoveDistance + 1, 0);
+        int32 LastShell = FMath::Min(RingBoundary + MoveDistance, InNewWindow.Radius);
+        for (int32 Shell = FirstShell; Shell <= LastShell; Shell++)
+        {
+            ForEachChunkInShell(InNewWindow.Center, Shell, [&](const FIntPoint& InChunk)
+                {
+                    OutRefreshChunks.Add(FChunkLocation(InChunk.X, InChunk.Y));
+                });
+        }
+    }
+}
+
+void ALandscapeCore::AsyncSpawnSection(const FChunkLocation& InVisibleChunk, const FVector& InLocation, int32 InLodDepth)
+{
+    int32 AdjSubDivitions = 4;
+    bool SpawnSectionFolaige = false;
+
+    if (bUseLODs && !LodDepths.IsEmpty())
+    {
+        AdjSubDivitions = LODRingTable.GetResolution(InLodDepth);
+        SpawnSectionFolaige = LODRingTable.ShouldSpawnFoliage(InLodDepth);
+    }
+    else if (SubDivitions >= 4)
+    {
+        AdjSubDivitions = SubDivitions;
+    }
+
+    URealtimeMeshComponent* NewChunkComponent = AcquireSectionComponent();
+    NewChunkComponent->SetVisibility(IsSectionRendered(InVisibleChunk));
+
+    FVector WorldLocation = FVector(InLocation.X + GetActorLocation().X, InLocation.Y + GetActorLocation().Y, InLocation.Z);
+    NewChunkComponent->SetWorldLocation(WorldLocation);
+
+    TStrongObjectPtr<URealtimeMeshSimple> RealtimeMeshSimple = TStrongObjectPtr<URealtimeMeshSimple>(NewChunkComponent->GetRealtimeMeshAs<URealtimeMeshSimple>());
+    
+    TSharedPtr<LandscapeSectionData> LandscapeSection = MakeShared<LandscapeSectionData>(RealtimeMeshSimple.Get(), StreamSet, LandscapeNoiseParams,FChunkParams(
+        TerrainMaterial,                                          
+        SectionScale,                                              
+        AdjSubDivitions,                                           
+        SectionScale / AdjSubDivitions,                           
+        UVScale,                                                   
+        float(SectionScale * InVisibleChunk.XLocation),            
+        float(SectionScale * InVisibleChunk.YLocation)),           
+        BiomeBlender, 
+        GetActorLocation(),
+        GetWorld(),
+        WorldXOffset,
+        WorldYOffset);
+
+    // Game worlds cook collision later, once a physics relevant actor comes close, See UpdateSectionCollision,
+    // Except for chunks an actor is standing in or next to, Those get complex collision with the section so nothing falls through while it streams in.
+    // Outside of game worlds there are no actors to follow so complex collision is built with the section.
+    bool bCommitImmediately = !GetWorld()->IsGameWorld();
+    bool bCreateCollision = (bCommitImmediately || PriorityCollisionChunks.Contains(InVisibleChunk)) && GetCollisionPolicy(InLodDepth) == ELandscapeCollisionPolicy::Complex;
+
+    FSectionJobTokenPtr JobToken = IssueSectionJobToken(InVisibleChunk, false);
+    LandscapeSection->SetCancellationToken(JobToken);
+    LandscapeSection->SetBiomePointCache(BiomePointCache);
+    LandscapeSection->SetSharedTopology(GetSectionTopology(AdjSubDivitions));
+    LandscapeSection->SetCreateCollision(bCreateCollision);
+
+    FLandscapeChunkRecord& ChunkRecord = FindOrAddChunkRecord(InVisibleChunk);
+    ChunkRecord.bGenerated = true;
+    ChunkRecord.SectionMeshComponent = NewChunkComponent;
+    ChunkRecord.CurrentLODDepth = InLodDepth;
+    ChunkRecord.GenerationData = LandscapeSection;
+    ChunkRecord.CollisionState = bCreateCollision ? ELandscapeCollisionPolicy::Complex : ELandscapeCollisionPolicy::None;
+    NumSectionJobsInFlight++;
+   
+    FSectionBuildContext BuildContext(LandscapeSection, RealtimeMeshSimple.Get(), GetSectionGroupKey(InVisibleChunk), FIntPoint(InVisibleChunk.XLocation, InVisibleChunk.YLocation),
+        AdjSubDivitions, false, JobToken, GetSectionTopology(AdjSubDivitions), ChunkCache, HeightfieldStore);
+    BuildContext.bCreateCollision = bCreateCollision;
+    BuildContext.BakedArchive = BakedArchive;
+    BuildContext.HeightQuantization = GetHeightQuantization();
+    BuildContext.Edits = EditLayer.GetSnapshot(FIntPoint(InVisibleChunk.XLocation, InVisibleChunk.YLocation));
+
+    AsyncTask(ENamedThreads::AnyHiPriThreadHiPriTask, [this, BuildContext, InVisibleChunk, SpawnSectionFolaige, bCommitImmediately]()
+        {
+            // Jobs cancelled while waiting in the task queue never start generating.
+            double BuildStartTime = FPlatformTime::Seconds();
+            BuildSectionOnWorker(BuildContext);
+            QueueSectionCommit(InVisibleChunk, BuildContext.JobToken, SpawnSectionFolaige, bCommitImmediately, float((FPlatformTime::Seconds() - BuildStartTime) * 1000.0));
+        });
+}
+
+void ALandscapeCore::AsyncUpdateSection(const FChunkLocation& InVisibleChunk, const FVector& InLocation, int32 InLodDepth)
+{
+    int32 AdjSubDivitions = 4;
+    FLandscapeChunkRecord* ChunkRecord = FindChunkRecord(InVisibleChunk);
+    URealtimeMeshComponent* SectionRealtimeMeshComp = nullptr;
+    bool SpawnSectionFolaige = false;
+
+    if (bUseLODs && !LodDepths.IsEmpty())
+    {
+        AdjSubDivitions = LODRingTable.GetResolution(InLodDepth);
+        SpawnSectionFolaige = LODRingTable.ShouldSpawnFoliage(InLodDepth);
+    }
+    else if (SubDivitions >= 4)
+    {
+        AdjSubDivitions = SubDivitions;
+    }
+
+    if (ChunkRecord && ChunkRecord->bGenerated)
+    {
+        SectionRealtimeMeshComp = ChunkRecord->SectionMeshComponent;
+    }
+    else
+    {
+        if (GEngine)
+        {
+            int32 XLocationtest = InVisibleChunk.XLocation;
+            int32 YLocationtest = InVisibleChunk.YLocation;
+            FString Message = FString::Printf(TEXT("Active Section dose not contain Data for location : X=%d, Y=%d"), XLocationtest, YLocationtest);
+            GEngine->AddOnScreenDebugMessage(-1, 10.f, FColor::Red, Message);
+        }
+        return;
+    }
+
+    if (SectionRealtimeMeshComp == nullptr)
+    {
+        if (GEngine)
+        {
+            FString Message = FString::Printf(TEXT("Update Section : RealtimeMeshComp Is = to NullPtr"));
+            GEngine->AddOnScreenDebugMessage(-1, 10.f, FColor::Red, Message);
+        }
+        return;
+    }
+
+    FVector WorldLocation = FVector(InLocation.X + GetActorLocation().X, InLocation.Y + GetActorLocation().Y, InLocation.Z);
+    TStrongObjectPtr<URealtimeMeshSimple> RealtimeMeshSimple = TStrongObjectPtr<URealtimeMeshSimple>(SectionRealtimeMeshComp->GetRealtimeMeshAs<URealtimeMeshSimple>());
+
+    TSharedPtr<LandscapeSectionData> LandscapeSection = MakeShared<LandscapeSectionData>(RealtimeMeshSimple.Get(), StreamSet, LandscapeNoiseParams, FChunkParams(
+        TerrainMaterial,                                           
+        SectionScale,                                              
+        AdjSubDivitions,                                           
+        SectionScale / AdjSubDivitions,                            
+        UVScale,                                                   
+        double(SectionScale * InVisibleChunk.XLocation),           
+        double(SectionScale * InVisibleChunk.YLocation)),          
+        BiomeBlender,
+        GetActorLocation(),
+        GetWorld(),
+        WorldXOffset,
+        WorldYOffset);
+
+    // Complex collision the section already has is kept through the rebuild so actors standing on it never fall through,
+    // Any other collision is rebuilt by UpdateSectionCollision once the job has been committed.
+    bool bKeepCollision = GetCollisionPolicy(InLodDepth) == ELandscapeCollisionPolicy::Complex
+        && (ChunkRecord->CollisionState == ELandscapeCollisionPolicy::Complex || !GetWorld()->IsGameWorld());
+    if (bKeepCollision)
+    {
+        ChunkRecord->CollisionState = ELandscapeCollisionPolicy::Complex;
+    }
+    else if (ChunkRecord->CollisionState == ELandscapeCollisionPolicy::Complex)
+    {
+        ChunkRecord->CollisionState = ELandscapeCollisionPolicy::None;
+    }
+    ChunkRecord->bCollisionDirty = ChunkRecord->CollisionState == ELandscapeCollisionPolicy::Simplified;
+
+    FSectionJobTokenPtr JobToken = IssueSectionJobToken(InVisibleChunk, true);
+    LandscapeSection->SetCancellationToken(JobToken);
+    LandscapeSection->SetBiomePointCache(BiomePointCache);
+    LandscapeSection->SetSharedTopology(GetSectionTopology(AdjSubDivitions));
+    LandscapeSection->SetCreateCollision(bKeepCollision);
+
+    if (!ChunkRecord->HasJobInFlight())
+    {
+        ChunkRecord->PreviousLODDepth = ChunkRecord->CurrentLODDepth;
+    }
+    ChunkRecord->GenerationData = LandscapeSection;
+    ChunkRecord->CurrentLODDepth = InLodDepth;
+    NumSectionJobsInFlight++;
+    
+    FSectionBuildContext BuildContext(LandscapeSection, RealtimeMeshSimple.Get(), GetSectionGroupKey(InVisibleChunk), FIntPoint(InVisibleChunk.XLocation, InVisibleChunk.YLocation),
+        AdjSubDivitions, true, JobToken, GetSectionTopology(AdjSubDivitions), ChunkCache, HeightfieldStore);
+    BuildContext.bCreateCollision = bKeepCollision;
+    BuildContext.BakedArchive = BakedArchive;
+    BuildContext.HeightQuantization = GetHeightQuantization();
+    BuildContext.Edits = EditLayer.GetSnapshot(FIntPoint(InVisibleChunk.XLocation, InVisibleChunk.YLocation));
+    bool bCommitImmediately = !GetWorld()->IsGameWorld();
+
+    AsyncTask(ENamedThreads::AnyHiPriThreadHiPriTask, [this, BuildContext, InVisibleChunk, SpawnSectionFolaige, bCommitImmediately]()
+        {
+            double BuildStartTime = FPlatformTime::Seconds();
+            BuildSectionOnWorker(BuildContext);
+            QueueSectionCommit(InVisibleChunk, BuildContext.JobToken, SpawnSectionFolaige, bCommitImmediately, float((FPlatformTime::Seconds() - BuildStartTime) * 1000.0));
+        });
+}
+
+// Section Component Pool
+
+// Returns an idle component from the pool or creates a new one when the pool is empty.
+// Pooled components keep their realtime mesh and collision config, Only the section group is rebuilt by the next job.
+URealtimeMeshComponent* ALandscapeCore::AcquireSectionComponent()
+{
+    while (!SectionComponentPool.IsEmpty())
+    {
+        URealtimeMeshComponent* PooledComponent = SectionComponentPool.Pop(false);
+        if (IsValid(PooledComponent))
+        {
+            PooledComponent->SetVisibility(true);
+            PooledComponent->SetCollisionEnabled(ECollisionEnabled::QueryAndPhysics);
+            return PooledComponent;
+        }
+    }
+    return CreateSectionComponent();
+}
+
+URealtimeMeshComponent* ALandscapeCore::CreateSectionComponent()
+{
+    FRealtimeMeshCollisionConfiguration CollisionConfig;
+    CollisionConfig.bShouldFastCookMeshes = true;
+    CollisionConfig.bUseComplexAsSimpleCollision = true;
+    CollisionConfig.bDeformableMesh = false;
+    CollisionConfig.bUseAsyncCook = true;
+
+    URealtimeMeshComponent* NewChunkComponent = NewObject<URealtimeMeshComponent>(this, URealtimeMeshComponent::StaticClass());
+    NewChunkComponent->RegisterComponent();
+    NewChunkComponent->AttachToComponent(GetRootComponent(), FAttachmentTransformRules::KeepRelativeTransform);
+    NewChunkComponent->SetMaterial(0, TerrainMaterial);
+    NewChunkComponent->SetCollisionEnabled(ECollisionEnabled::QueryAndPhysics);
+    NewChunkComponent->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Block);
+
+    URealtimeMeshSimple* RealtimeMeshSimple = NewChunkComponent->InitializeRealtimeMesh<URealtimeMeshSimple>();
+    RealtimeMeshSimple->SetCollisionConfig(CollisionConfig);
+
+    return NewChunkComponent;
+}
+
+// Clears the sections mesh and parks the component in the pool,
+// Components beyond the pool high water mark are destroyed instead so a long trip does not leave hundreds of idle components behind.
+void ALandscapeCore::ReleaseSectionComponent(URealtimeMeshComponent* InComponent, const FChunkLocation& InSectionLocation)
+{
+    if (!IsValid(InComponent))
+    {
+        return;
+    }
+
+    if (SectionComponentPool.Num() >= FMath::Max(SectionPoolHighWaterMark, SectionPoolSize))
+    {
+        InComponent->DestroyComponent();
+        return;
+    }
+
+    if (URealtimeMeshSimple* RealtimeMesh = InComponent->GetRealtimeMeshAs<URealtimeMeshSimple>())
+    {
+        RealtimeMesh->RemoveSectionGroup(GetSectionGroupKey(InSectionLocation));
+    }
+    InComponent->SetVisibility(false);
+    InComponent->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+    SectionComponentPool.Add(InComponent);
+}
+
+// Fills the pool up to SectionPoolSize so the first chunk border crossings do not pay for component creation.
+void ALandscapeCore::PrewarmSectionPool()
+{
+    while (SectionComponentPool.Num() < SectionPoolSize)
+    {
+        URealtimeMeshComponent* PooledComponent = CreateSectionComponent();
+        PooledComponent->SetVisibility(false);
+        PooledComponent->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+        SectionComponentPool.Add(PooledComponent);
+    }
+}
+
+// Section Collision
+
+// Adds an actor that needs collision around it (physics props, AI, vehicles), Streaming viewers always do and need not be registered.
+void ALandscapeCore::RegisterCollisionActor(AActor* InActor)
+{
+    if (IsValid(InActor))
+    {
+        CollisionActors.AddUnique(InActor);
+    }
+}
+
+void ALandscapeCore::UnregisterCollisionActor(AActor* InActor)
+{
+    CollisionActors.Remove(InActor);
+}
+
+// Builds collision only for sections within CollisionActivationRadius (rounded up to whole chunks) of a streaming viewer or registered collision actor,
+// using the collision policy of the sections Lod depth. Closest sections are built first, at most MaxCollisionUpdatesPerTick a tick,
+// Sections no actor is close to anymore drop their collision right away.
+// Every actor keeps a collision window and CollisionDemand counts the windows covering each chunk, Kept up to date like the section demand
+// so only the strips entering and leaving a window are visited. Chunks that may need work wait in PendingCollisionChunks,
+// Committed sections inside a window are added back so a changed Lod depth picks up its new policy.
+void ALandscapeCore::UpdateSectionCollision(const TArray<FLandscapeStreamingViewer>& InViewers)
+{
+    LANDSCAPE_SCOPE(STAT_LandscapeCollision);
+
+    int32 ChunkRadius = FMath::Max(FMath::CeilToInt32(CollisionActivationRadius / SectionScale), 0);
+    TMap<TWeakObjectPtr<AActor>, FLandscapeViewerWindow> NewWindows;
+    for (const FLandscapeStreamingViewer& Viewer : InViewers)
+    {
+        if (Viewer.Actor.IsValid())
+        {
+            NewWindows.Add(Viewer.Actor, FLandscapeViewerWindow(Viewer.Chunk, ChunkRadius, 0, true));
+        }
+    }
+    for (auto It = CollisionActors.CreateIterator(); It; ++It)
+    {
+        if (AActor* CollisionActor = It->Get())
+        {
+            FChunkLocation ActorChunk = GetChunkForLocation(CollisionActor->GetActorLocation());
+            NewWindows.Add(*It, FLandscapeViewerWindow(FIntPoint(ActorChunk.XLocation, ActorChunk.YLocation), ChunkRadius, 0, true));
+        }
+        else
+        {
+            It.RemoveCurrent();
+        }
+    }
+
+    // The chunks every actor stands in and their neighbours, Built as soon as their section commits and never held back by MaxCollisionUpdatesPerTick.
+    PriorityCollisionChunks.Reset();
+    for (const TPair<TWeakObjectPtr<AActor>, FLandscapeViewerWindow>& Window : NewWindows)
+    {
+        for (int32 X = -1; X <= 1; X++)
+        {
+            for (int32 Y = -1; Y <= 1; Y++)
+            {
+                PriorityCollisionChunks.Add(FChunkLocation(Window.Value.Center.X + X, Window.Value.Center.Y + Y));
+            }
+        }
+    }
+
+    if (!NewWindows.OrderIndependentCompareEqual(CollisionWindows))
+    {
+        TMap<TWeakObjectPtr<AActor>, FLandscapeViewerWindow> OldWindows = MoveTemp(CollisionWindows);
+        CollisionWindows = MoveTemp(NewWindows);
+
+        for (const TPair<TWeakObjectPtr<AActor>, FLandscapeViewerWindow>& OldWindow : OldWindows)
+        {
+            const FLandscapeViewerWindow* NewWindow = CollisionWindows.Find(OldWindow.Key);
+            bool bKeepsRadius = NewWindow && NewWindow->Radius == OldWindow.Value.Radius;
+            ForEachChunkInWindowDifference(OldWindow.Value, bKeepsRadius ? NewWindow : nullptr, [&](const FIntPoint& InChunk)
+                {
+                    FChunkLocation SectionLocation(InChunk.X, InChunk.Y);
+                    int32* Demand = CollisionDemand.Find(SectionLocation);
+                    if (Demand && --(*Demand) <= 0)
+                    {
+                        CollisionDemand.Remove(SectionLocation);
+                        PendingCollisionChunks.Add(SectionLocation);
+                    }
+                });
+        }
+
+        for (const TPair<TWeakObjectPtr<AActor>, FLandscapeViewerWindow>& NewWindow : CollisionWindows)
+        {
+            const FLandscapeViewerWindow* OldWindow = OldWindows.Find(NewWindow.Key);
+            bool bKeepsRadius = OldWindow && OldWindow->Radius == NewWindow.Value.Radius;
+            ForEachChunkInWindowDifference(NewWindow.Value, bKeepsRadius ? OldWindow : nullptr, [&](const FIntPoint& InChunk)
+                {
+                    FChunkLocation SectionLocation(InChunk.X, InChunk.Y);
+                    if (CollisionDemand.FindOrAdd(SectionLocation, 0)++ == 0)
+                    {
+                        PendingCollisionChunks.Add(SectionLocation);
+                    }
+                });
+        }
+    }
+
+    if (PendingCollisionChunks.IsEmpty())
+    {
+        return;
+    }
+
+    // Squared chunk distance to the closest actor of every pending section that should have collision.
+    TArray<TPair<int32, FChunkLocation>> CollisionUpdates;
+    for (auto It = PendingCollisionChunks.CreateIterator(); It; ++It)
+    {
+        // Sections with a job in flight stay pending until the job has stopped, Sections not generated yet are added back once they commit.
+        FLandscapeChunkRecord* ChunkRecord = FindChunkRecord(*It);
+        if (!ChunkRecord || (!ChunkRecord->bGenerated && !ChunkRecord->HasJobInFlight()))
+        {
+            ActiveCollisionSections.Remove(*It);
+            It.RemoveCurrent();
+            continue;
+        }
+        if (ChunkRecord->HasJobInFlight())
+        {
+            continue;
+        }
+
+        if (!CollisionDemand.Contains(*It))
+        {
+            if (ChunkRecord->CollisionState == ELandscapeCollisionPolicy::None || ApplySectionCollision(*It, *ChunkRecord, ELandscapeCollisionPolicy::None))
+            {
+                ActiveCollisionSections.Remove(*It);
+                It.RemoveCurrent();
+            }
+            continue;
+        }
+
+        if (!ChunkRecord->bCollisionDirty && ChunkRecord->CollisionState == GetCollisionPolicy(ChunkRecord->CurrentLODDepth))
+        {
+            It.RemoveCurrent();
+            continue;
+        }
+
+        int32 ChunkDistance = MAX_int32;
+        for (const TPair<TWeakObjectPtr<AActor>, FLandscapeViewerWindow>& Window : CollisionWindows)
+        {
+            ChunkDistance = FMath::Min(ChunkDistance, FMath::Square(It->XLocation - Window.Value.Center.X) + FMath::Square(It->YLocation - Window.Value.Center.Y));
+        }
+        CollisionUpdates.Emplace(ChunkDistance, *It);
+    }
+
+    CollisionUpdates.Sort([](const TPair<int32, FChunkLocation>& A, const TPair<int32, FChunkLocation>& B) { return A.Key < B.Key; });
+
+    int32 MaxUpdates = FMath::Max(MaxCollisionUpdatesPerTick, 1);
+    int32 NumUpdates = 0;
+    for (const TPair<int32, FChunkLocation>& CollisionUpdate : CollisionUpdates)
+    {
+        const FChunkLocation& SectionLocation = CollisionUpdate.Value;
+        bool bPriority = PriorityCollisionChunks.Contains(SectionLocation);
+        if (!bPriority && NumUpdates >= MaxUpdates)
+        {
+            continue;
+        }
+
+        FLandscapeChunkRecord* ChunkRecord = FindChunkRecord(SectionLocation);
+        if (RefreshSectionCollision(SectionLocation, *ChunkRecord))
+        {
+            PendingCollisionChunks.Remove(SectionLocation);
+            NumUpdates += bPriority ? 0 : 1;
+        }
+    }
+}
+
+// Builds the collision policy of the sections Lod depth and keeps ActiveCollisionSections in step, Returns false if the section cannot take it yet.
+bool ALandscapeCore::RefreshSectionCollision(const FChunkLocation& InSectionLocation, FLandscapeChunkRecord& InChunkRecord)
+{
+    ELandscapeCollisionPolicy Policy = GetCollisionPolicy(InChunkRecord.CurrentLODDepth);
+    if ((InChunkRecord.bCollisionDirty || InChunkRecord.CollisionState != Policy) && !ApplySectionCollision(InSectionLocation, InChunkRecord, Policy))
+    {
+        return false;
+    }
+
+    if (InChunkRecord.CollisionState != ELandscapeCollisionPolicy::None)
+    {
+        ActiveCollisionSections.Add(InSectionLocation);
+    }
+    else
+    {
+        ActiveCollisionSections.Remove(InSectionLocation);
+    }
+    return true;
+}
+
+// Switches a section to InPolicy, Complex collision is cooked from the rendered section,
+// Simplified collision is an invisible grid in its own section group resampled from the heightfield the section job published.
+// Returns false if the section cannot take the collision yet, it is tried again on the next tick.
+bool ALandscapeCore::ApplySectionCollision(const FChunkLocation& InSectionLocation, FLandscapeChunkRecord& InChunkRecord, ELandscapeCollisionPolicy InPolicy)
+{
+    URealtimeMeshSimple* RealtimeMesh = InChunkRecord.SectionMeshComponent ? InChunkRecord.SectionMeshComponent->GetRealtimeMeshAs<URealtimeMeshSimple>() : nullptr;
+    if (!RealtimeMesh)
+    {
+        return false;
+    }
+
+    FRealtimeMeshSectionGroupKey CollisionGroupKey = GetSectionCollisionGroupKey(InSectionLocation);
+    if (InPolicy == ELandscapeCollisionPolicy::Simplified)
+    {
+        FLandscapeHeightfieldTilePtr SectionTile = HeightfieldStore ? HeightfieldStore->FindTile(FIntPoint(InSectionLocation.XLocation, InSectionLocation.YLocation)) : nullptr;
+        if (!SectionTile)
+        {
+            return false;
+        }
+
+        int32 CollisionResolution = FMath::Clamp(SimplifiedCollisionResolution, 1, SectionTile->Resolution);
+        FLandscapeHeightfieldTile CollisionTile;
+        CollisionTile.ResampleFrom(*SectionTile, CollisionResolution);
+
+        FRealtimeMeshSectionConfig CollisionSectionConfig(ERealtimeMeshSectionDrawType::Static, 0);
+        CollisionSectionConfig.bIsVisible = false;
+        CollisionSectionConfig.bCastsShadow = false;
+        CollisionTile.ApplyToRealtimeMesh(RealtimeMesh, CollisionGroupKey, *GetSectionTopology(CollisionResolution),
+            InChunkRecord.CollisionState == ELandscapeCollisionPolicy::Simplified, CollisionSectionConfig, true);
+    }
+    else if (InChunkRecord.CollisionState == ELandscapeCollisionPolicy::Simplified)
+    {
+        RealtimeMesh->RemoveSectionGroup(CollisionGroupKey);
+    }
+
+    bool bComplex = InPolicy == ELandscapeCollisionPolicy::Complex;
+    if (bComplex != (InChunkRecord.CollisionState == ELandscapeCollisionPolicy::Complex))
+    {
+        FRealtimeMeshSectionKey SectionKey = FRealtimeMeshSectionKey::CreateForPolyGroup(GetSectionGroupKey(InSectionLocation), 0);
+        RealtimeMesh->UpdateSectionConfig(SectionKey, FRealtimeMeshSectionConfig(ERealtimeMeshSectionDrawType::Static, 0), bComplex);
+    }
+
+    InChunkRecord.CollisionState = InPolicy;
+    InChunkRecord.bCollisionDirty = false;
+    return true;
+}
+
+// Drops the simplified collision grid of a section being removed, The section group itself goes with the component.
+void ALandscapeCore::RemoveSectionCollision(const FChunkLocation& InSectionLocation, const FLandscapeChunkRecord& InChunkRecord)
+{
+    ActiveCollisionSections.Remove(InSectionLocation);
+    if (InChunkRecord.CollisionState != ELandscapeCollisionPolicy::Simplified || !InChunkRecord.SectionMeshComponent)
+    {
+        return;
+    }
+    if (URealtimeMeshSimple* RealtimeMesh = InChunkRecord.SectionMeshComponent->GetRealtimeMeshAs<URealtimeMeshSimple>())
+    {
+        RealtimeMesh->RemoveSectionGroup(GetSectionCollisionGroupKey(InSectionLocation));
+    }
+}
+
+ELandscapeCollisionPolicy ALandscapeCore::GetCollisionPolicy(int32 InLodDepth)
+{
+    if (bUseLODs && LODRingTable.IsValidLOD(InLodDepth))
+    {
+        return LODRingTable.GetCollisionPolicy(InLodDepth);
+    }
+    return ELandscapeCollisionPolicy::Complex;
+}
+
+// Extrapolates every viewer along its velocity and queues low priority spawns for the chunks its generation distance will cover
+// once it gets there, so crossing a border finds most of the new row already built instead of queuing it all at once.
+// Prefetched sections are kept out of removal while they stay ahead of a viewer, If it turns away they are removed like any other section.
+// Each viewer keeps a look-ahead window, PrefetchedSections counts the windows covering each chunk and is kept up to date the same way
+// as the section demand, Only the strips entering and leaving a window are visited so a viewer holding its course costs nothing.
+// A chunk already inside a window keeps the Lod depth it was queued with, It gets its final depth once a viewers generation distance reaches it.
+void ALandscapeCore::PrefetchSections(const TArray<FLandscapeStreamingViewer>& InViewers)
+{
+    TMap<TWeakObjectPtr<AActor>, FLandscapeViewerWindow> NewWindows;
+    int32 MaxLookAhead = FMath::Max(MaxPrefetchChunks, 1);
+
+    for (const FLandscapeStreamingViewer& Viewer : InViewers)
+    {
+        FVector2D PlanarVelocity(Viewer.Velocity.X, Viewer.Velocity.Y);
+        if (PlanarVelocity.Size() < MinPrefetchSpeed)
+        {
+            continue;
+        }
+
+        FChunkLocation PredictedChunk = GetChunkForLocation(Viewer.Actor->GetActorLocation() + FVector(PlanarVelocity * PrefetchLookAheadTime, 0.0f));
+        FIntPoint LookAheadCenter(
+            Viewer.Chunk.X + FMath::Clamp(PredictedChunk.XLocation - Viewer.Chunk.X, -MaxLookAhead, MaxLookAhead),
+            Viewer.Chunk.Y + FMath::Clamp(PredictedChunk.YLocation - Viewer.Chunk.Y, -MaxLookAhead, MaxLookAhead));
+
+        if (LookAheadCenter == Viewer.Chunk)
+        {
+            continue;
+        }
+
+        int32 GenerationDistance = Viewer.GenerationDistance > 0 ? Viewer.GenerationDistance : GetGenerationDisantance();
+        NewWindows.Add(Viewer.Actor, FLandscapeViewerWindow(LookAheadCenter, GenerationDistance, Viewer.LODBias, true));
+    }
+
+    if (NewWindows.OrderIndependentCompareEqual(PrefetchWindows))
+    {
+        return;
+    }
+
+    TMap<TWeakObjectPtr<AActor>, FLandscapeViewerWindow> OldWindows = MoveTemp(PrefetchWindows);
+    PrefetchWindows = MoveTemp(NewWindows);
+
+    auto KeepsSettings = [](const FLandscapeViewerWindow* InOldWindow, const FLandscapeViewerWindow* InNewWindow)
+        {
+            return InOldWindow && InNewWindow && InOldWindow->Radius == InNewWindow->Radius && InOldWindow->LODBias == InNewWindow->LODBias;
+        };
+
+    for (const TPair<TWeakObjectPtr<AActor>, FLandscapeViewerWindow>& OldWindow : OldWindows)
+    {
+        const FLandscapeViewerWindow* NewWindow = PrefetchWindows.Find(OldWindow.Key);
+        ForEachChunkInWindowDifference(OldWindow.Value, KeepsSettings(&OldWindow.Value, NewWindow) ? NewWindow : nullptr, [&](const FIntPoint& InChunk)
             {
-                if (bUseLODs && !LodDepths.IsEmpty())
+                FChunkLocation PrefetchChunk(InChunk.X, InChunk.Y);
+                int32* PrefetchCount = PrefetchedSections.Find(PrefetchChunk);
+                if (!PrefetchCount || --(*PrefetchCount) > 0)
+                {
+                    return;
+                }
+
+                // Chunks a viewer still covers keep their section and their (regular) job.
+                PrefetchedSections.Remove(PrefetchChunk);
+                if (SectionDemands.Contains(PrefetchChunk))
                 {
-                    int32 ChunkIndexLodDepth = GetLODForIndex(AbsXChunkIndex, AbsYChunkIndex);
-                    AsyncSpawnSection(VisibleChunk, Location, ChunkIndexLodDepth);
+                    return;
                 }
-                else if (AbsXChunkIndex <= Distance && AbsYChunkIndex <= Distance)
+                if (IsChunkGenerated(PrefetchChunk))
                 {
-                    AsyncSpawnSection(VisibleChunk, Location, 0);
+                    PendingRemovals.Add(PrefetchChunk);
                 }
-            }
-            if (GeneratedChunks.Contains(VisibleChunk) && ActiveSections.Contains(VisibleChunk) && !Initilization && bUseLODs && !LodDepths.IsEmpty())
+                ChunkScheduler.Remove(InChunk);
+            });
+    }
+
+    for (const TPair<TWeakObjectPtr<AActor>, FLandscapeViewerWindow>& NewWindow : PrefetchWindows)
+    {
+        const FLandscapeViewerWindow* OldWindow = OldWindows.Find(NewWindow.Key);
+        const FLandscapeViewerWindow& Window = NewWindow.Value;
+        ForEachChunkInWindowDifference(Window, KeepsSettings(OldWindow, &Window) ? OldWindow : nullptr, [&](const FIntPoint& InChunk)
             {
-                FSectionNode SectionNode = ActiveSections.FindRef(VisibleChunk);
-                int32 SectionLOD = SectionNode.CurrentLODDepth;
-                int32 ChunkIndexLodDepth = GetLODForIndex(AbsXChunkIndex, AbsYChunkIndex);
-                if (SectionLOD != ChunkIndexLodDepth)
+                FChunkLocation PrefetchChunk(InChunk.X, InChunk.Y);
+                if (PrefetchedSections.FindOrAdd(PrefetchChunk, 0)++ > 0 || RenderedSections.Contains(PrefetchChunk) || IsChunkGenerated(PrefetchChunk))
                 {
-                    AsyncUpdateSection(VisibleChunk, Location, ChunkIndexLodDepth);
+                    return;
                 }
+
+                // Sections are built at the Lod depth they will have once the viewer reaches the predicted chunk.
+                int32 PrefetchLodDepth = GetViewerLODForIndex(Window.LODBias, abs(InChunk.X - Window.Center.X), abs(InChunk.Y - Window.Center.Y));
+                ChunkScheduler.Enqueue(InChunk, PrefetchLodDepth, false, true);
+            });
+    }
+}
+
+// Removes the sections queued in PendingRemovals, Only chunks that left every viewers window are visited.
+void ALandscapeCore::RemoveSections()
+{
+    LANDSCAPE_SCOPE(STAT_LandscapeRemoveSections);
+
+    for (auto It = PendingRemovals.CreateIterator(); It; ++It)
+    {
+        FChunkLocation MeshKey = *It;
+
+        // Prefetched sections stay queued until a viewer reaches them or they drop out of the prefetch set.
+        if (PrefetchedSections.Contains(MeshKey))
+        {
+            continue;
+        }
+        FLandscapeChunkRecord* ChunkRecord = FindChunkRecord(MeshKey);
+        if (!ChunkRecord || !ChunkRecord->bGenerated)
+        {
+            It.RemoveCurrent();
+            continue;
+        }
+
+        // Sections with a job still in flight have the job cancelled and are removed on a later tick once it has stopped.
+        if (ChunkRecord->HasJobInFlight())
+        {
+            CancelSectionJob(MeshKey, false);
+            continue;
+        }
+
+        URealtimeMeshComponent* RemoveMesh = ChunkRecord->SectionMeshComponent;
+        APCGSectionFoliage* FoliageSection = ChunkRecord->FoliageSection.Get();
+        if (!FoliageSection)
+        {
+            UE_LOG(LogTemp, Warning, TEXT("Could Not Find Foliage Section For Key : %d , $d"),MeshKey.XLocation, MeshKey.YLocation);
+        }
+       
+        if (RemoveMesh)
+        {
+            RemoveSectionFoliageInstances(*ChunkRecord);
+            RemoveSectionCollision(MeshKey, *ChunkRecord);
+            RemoveChunkRecord(MeshKey);
+            RemoveSectionHeightfield(MeshKey);
+            ReleaseSectionComponent(RemoveMesh, MeshKey);
+            if (FoliageSection)
+            {
+                FoliageSection->CleanUpFoliage();
+                FoliageSection->Destroy();
+            }
+        }
+        else
+        {
+            if (GEngine)
+            {
+                int32 XLocationtest = MeshKey.XLocation;
+                int32 YLocationtest = MeshKey.YLocation;
+                FString Message = FString::Printf(TEXT("Remove location was Null Ptr : X=%d, Y=%d"), XLocationtest, YLocationtest);
+                GEngine->AddOnScreenDebugMessage(-1, 50.f, FColor::Red, Message);
             }
         }
+        It.RemoveCurrent();
     }
 }
 
-void ALandscapeCore::AsyncSpawnSection(const FChunkLocation& InVisibleChunk, const FVector& InLocation, int32 InLodDepth)
+
+
+// Terrain Editing
+
+// Edits the terrain under InStroke, Only with authority (the server, a standalone game or the editor), Clients receive the edit tiles it changed.
+void ALandscapeCore::ApplyBrush(const FLandscapeBrushStroke& InStroke)
 {
-    int32 AdjSubDivitions = 4;
-    bool SpawnSectionFolaige = false;
+    LANDSCAPE_SCOPE(STAT_LandscapeTerrainEdit);
 
-    if (bUseLODs && !LodDepths.IsEmpty())
+    if (!HasAuthority())
     {
-        AdjSubDivitions = LodDepths[InLodDepth].LODResolution;
-        SpawnSectionFolaige = LodDepths[InLodDepth].bLODSpawnFolaige;
+        UE_LOG(LogTemp, Warning, TEXT("Landscape Edit : Brushes can only be applied with authority, Route the edit through the server"));
+        return;
     }
-    else if (SubDivitions >= 4)
+    ConfigureEditLayer();
+
+    TSet<FIntPoint> EditedSections;
+    FindEditedSections(EditLayer.GetStrokeBounds(InStroke, GetActorLocation()), EditedSections);
+
+    TMap<FIntPoint, FLandscapeEditSnapshot> PreviousEdits;
+    for (const FIntPoint& Section : EditedSections)
     {
-        AdjSubDivitions = SubDivitions;
+        PreviousEdits.Add(Section, EditLayer.GetSnapshot(Section));
     }
 
-    FRealtimeMeshCollisionConfiguration CollisionConfig;
-    CollisionConfig.bShouldFastCookMeshes = true;
-    CollisionConfig.bUseComplexAsSimpleCollision = true;
-    CollisionConfig.bDeformableMesh = false;
-    CollisionConfig.bUseAsyncCook = true;
+    TArray<FIntPoint> ChangedChunks;
+    EditLayer.ApplyBrush(InStroke, GetActorLocation(), HeightfieldStore.Get(), ChangedChunks);
+    if (ChangedChunks.IsEmpty())
+    {
+        return;
+    }
 
-    URealtimeMeshComponent* NewChunkComponent = NewObject<URealtimeMeshComponent>(this, URealtimeMeshComponent::StaticClass());
-    NewChunkComponent->RegisterComponent();
-    NewChunkComponent->AttachToComponent(GetRootComponent(), FAttachmentTransformRules::KeepRelativeTransform);
-    NewChunkComponent->SetMaterial(0, TerrainMaterial);
-    NewChunkComponent->SetCollisionEnabled(ECollisionEnabled::QueryAndPhysics);
-    NewChunkComponent->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Block);
+    PublishEditTiles(ChangedChunks);
+    RegenerateEditedSections(PreviousEdits);
+}
 
-    FVector WorldLocation = FVector(InLocation.X + GetActorLocation().X, InLocation.Y + GetActorLocation().Y, InLocation.Z);
-    NewChunkComponent->SetWorldLocation(WorldLocation);
+// Writes every edit to InFilePath, compressed, for save games.
+bool ALandscapeCore::SaveEditLayer(const FString& InFilePath)
+{
+    TArray<uint8> EditData;
+    EditLayer.Save(EditData);
+    return FFileHelper::SaveArrayToFile(EditData, *InFilePath);
+}
 
-    TStrongObjectPtr<URealtimeMeshSimple> RealtimeMeshSimple = TStrongObjectPtr<URealtimeMeshSimple>(NewChunkComponent->InitializeRealtimeMesh<URealtimeMeshSimple>());    
-    RealtimeMeshSimple->SetCollisionConfig(CollisionConfig);
-    
-    TSharedPtr<LandscapeSectionData> LandscapeSection = MakeShared<LandscapeSectionData>(RealtimeMeshSimple.Get(), StreamSet, LandscapeNoiseParams,FChunkParams(
-        TerrainMaterial,                                          
-        SectionScale,                                              
-        AdjSubDivitions,                                           
-        SectionScale / AdjSubDivitions,                           
-        UVScale,                                                   
-        float(SectionScale * InVisibleChunk.XLocation),            
-        float(SectionScale * InVisibleChunk.YLocation)),           
-        BiomeBlender, 
-        GetActorLocation(),
-        GetWorld(),
-        WorldXOffset,
-        WorldYOffset);
+// Replaces every edit with the ones saved in InFilePath and rebuilds the sections that changed, Replicates like brush edits.
+bool ALandscapeCore::LoadEditLayer(const FString& InFilePath)
+{
+    LANDSCAPE_SCOPE(STAT_LandscapeTerrainEdit);
 
-    GeneratedChunks.Add(InVisibleChunk);
-    ActiveGenerationDataMap.Add(InVisibleChunk, LandscapeSection);
-    ActiveSections.Add(InVisibleChunk, FSectionNode(NewChunkComponent, InVisibleChunk, InLodDepth));
-   
-    AsyncTask(ENamedThreads::AnyHiPriThreadHiPriTask, [this, LandscapeSection, InLocation, InVisibleChunk, SpawnSectionFolaige]()
+    TArray<uint8> EditData;
+    if (!HasAuthority() || !FFileHelper::LoadFileToArray(EditData, *InFilePath))
+    {
+        return false;
+    }
+    ConfigureEditLayer();
+
+    // Which tiles the save touches is only known once it is loaded, So every section keeps the edits it was built with until then.
+    TMap<FIntPoint, FLandscapeEditSnapshot> SectionEdits;
+    ChunkTable.ForEach([this, &SectionEdits](const FIntPoint& InChunk, FLandscapeChunkRecord& InRecord)
         {
-            LandscapeSection->CreateChunk();
-           
-            AsyncTask(ENamedThreads::GameThread, [this, InLocation, InVisibleChunk, SpawnSectionFolaige]()
-                {
-                    FChunkLocation SectionLocation = InVisibleChunk;
-                    if (SpawnSectionFolaige)
-                    {
-                        HandleSectionFoliage(SectionLocation, false);
-                    }
-                    if (ActiveGenerationDataMap.Contains(SectionLocation))
-                    {
-                        ActiveGenerationDataMap.Remove(SectionLocation);
-                    }
-                });
+            if (InRecord.bGenerated)
+            {
+                SectionEdits.Add(InChunk, EditLayer.GetSnapshot(InChunk));
+            }
         });
-}
 
-void ALandscapeCore::AsyncUpdateSection(const FChunkLocation& InVisibleChunk, const FVector& InLocation, int32 InLodDepth)
-{
-    int32 AdjSubDivitions = 4;
-    FSectionNode SectionNode;
-    URealtimeMeshComponent* SectionRealtimeMeshComp = nullptr;
-    bool SpawnSectionFolaige = false;
+    TArray<FIntPoint> ChangedChunks;
+    if (!EditLayer.Load(EditData, ChangedChunks))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Landscape Edit : %s is corrupt or was saved for another section scale or edit resolution"), *InFilePath);
+        return false;
+    }
 
-    if (bUseLODs && !LodDepths.IsEmpty())
+    TSet<FIntPoint> EditedSections;
+    for (const FIntPoint& ChangedChunk : ChangedChunks)
     {
-        AdjSubDivitions = LodDepths[InLodDepth].LODResolution;
-        SpawnSectionFolaige = LodDepths[InLodDepth].bLODSpawnFolaige;
+        FindEditedSections(EditLayer.GetTileBounds(ChangedChunk), EditedSections);
     }
-    else if (SubDivitions >= 4)
+
+    TMap<FIntPoint, FLandscapeEditSnapshot> PreviousEdits;
+    for (const FIntPoint& Section : EditedSections)
     {
-        AdjSubDivitions = SubDivitions;
+        PreviousEdits.Add(Section, SectionEdits.FindRef(Section));
+    }
+
+    PublishEditTiles(ChangedChunks);
+    RegenerateEditedSections(PreviousEdits);
+    return true;
+}
+
+// Edits outlive regeneration, They are only dropped once they would no longer line up with the chunks.
+// A client that had to drop them takes every tile the server has replicated again.
+void ALandscapeCore::ConfigureEditLayer()
+{
+    int32 Resolution = FMath::Max(EditLayerResolution, 1);
+    if (EditLayer.GetSectionScale() == SectionScale && EditLayer.GetResolution() == Resolution)
+    {
+        return;
     }
 
-    if (ActiveSections.Contains(InVisibleChunk))
+    EditLayer.Reset(SectionScale, Resolution);
+    if (HasAuthority())
     {
-        SectionNode = ActiveSections.FindRef(InVisibleChunk);
-        SectionRealtimeMeshComp = SectionNode.SectionMeshComponent;
+        ReplicatedEditTiles.Empty();
     }
     else
     {
-        if (GEngine)
+        for (const FLandscapeEditTilePayload& Payload : ReplicatedEditTiles)
         {
-            int32 XLocationtest = InVisibleChunk.XLocation;
-            int32 YLocationtest = InVisibleChunk.YLocation;
-            FString Message = FString::Printf(TEXT("Active Section dose not contain Data for location : X=%d, Y=%d"), XLocationtest, YLocationtest);
-            GEngine->AddOnScreenDebugMessage(-1, 10.f, FColor::Red, Message);
+            EditLayer.ApplyPayload(Payload);
         }
+    }
+}
+
+// Updates the replicated payloads of InChunks, Only the changed entries are sent to clients and late joiners get every tile.
+void ALandscapeCore::PublishEditTiles(const TArray<FIntPoint>& InChunks)
+{
+    if (GetNetMode() == NM_Standalone)
+    {
         return;
     }
 
-    if (SectionRealtimeMeshComp == nullptr)
+    for (const FIntPoint& Chunk : InChunks)
     {
-        if (GEngine)
+        FLandscapeEditTilePayload Payload = EditLayer.MakePayload(Chunk);
+        int32 PayloadIndex = ReplicatedEditTiles.IndexOfByPredicate([&Chunk](const FLandscapeEditTilePayload& InPayload) { return InPayload.Chunk == Chunk; });
+        if (PayloadIndex == INDEX_NONE)
         {
-            FString Message = FString::Printf(TEXT("Update Section : RealtimeMeshComp Is = to NullPtr"));
-            GEngine->AddOnScreenDebugMessage(-1, 10.f, FColor::Red, Message);
+            ReplicatedEditTiles.Add(MoveTemp(Payload));
+        }
+        else
+        {
+            ReplicatedEditTiles[PayloadIndex] = MoveTemp(Payload);
+        }
+    }
+}
+
+void ALandscapeCore::OnRep_EditTiles()
+{
+    LANDSCAPE_SCOPE(STAT_LandscapeTerrainEdit);
+    ConfigureEditLayer();
+
+    TMap<FIntPoint, FLandscapeEditSnapshot> PreviousEdits;
+    for (const FLandscapeEditTilePayload& Payload : ReplicatedEditTiles)
+    {
+        FLandscapeEditTilePtr ExistingTile = EditLayer.FindTile(Payload.Chunk);
+        if (ExistingTile && ExistingTile->Revision == Payload.Revision)
+        {
+            continue;
+        }
+
+        // Taken before the tile changes, A section already collected for an earlier tile keeps the edits it was built with.
+        TSet<FIntPoint> EditedSections;
+        FindEditedSections(EditLayer.GetTileBounds(Payload.Chunk), EditedSections);
+        for (const FIntPoint& Section : EditedSections)
+        {
+            if (!PreviousEdits.Contains(Section))
+            {
+                PreviousEdits.Add(Section, EditLayer.GetSnapshot(Section));
+            }
+        }
+
+        if (!EditLayer.ApplyPayload(Payload))
+        {
+            UE_LOG(LogTemp, Warning, TEXT("Landscape Edit : Could not apply the edits of chunk (%d, %d)"), Payload.Chunk.X, Payload.Chunk.Y);
+        }
+    }
+
+    RegenerateEditedSections(PreviousEdits);
+}
+
+// Generated sections overlapping InBounds (relative to the landscape), Sections start at their grid origin inside the chunk
+// so the bounds are shifted by it, While no section has been published yet one more ring is taken instead.
+void ALandscapeCore::FindEditedSections(const FBox2D& InBounds, TSet<FIntPoint>& OutSections)
+{
+    FVector2f TileOrigin = FVector2f::ZeroVector;
+    double Padding = 0.0;
+    if (!HeightfieldStore || !HeightfieldStore->GetTileOrigin(TileOrigin))
+    {
+        Padding = SectionScale;
+    }
+
+    FVector2D SectionMin = InBounds.Min - FVector2D(TileOrigin) - FVector2D(Padding);
+    FVector2D SectionMax = InBounds.Max - FVector2D(TileOrigin) + FVector2D(Padding);
+    int32 MinX = FMath::CeilToInt32(SectionMin.X / SectionScale) - 1;
+    int32 MinY = FMath::CeilToInt32(SectionMin.Y / SectionScale) - 1;
+    int32 MaxX = FMath::FloorToInt32(SectionMax.X / SectionScale);
+    int32 MaxY = FMath::FloorToInt32(SectionMax.Y / SectionScale);
+
+    for (int32 X = MinX; X <= MaxX; X++)
+    {
+        for (int32 Y = MinY; Y <= MaxY; Y++)
+        {
+            const FLandscapeChunkRecord* ChunkRecord = FindChunkRecord(FChunkLocation(X, Y));
+            if (ChunkRecord && ChunkRecord->bGenerated)
+            {
+                OutSections.Add(FIntPoint(X, Y));
+            }
+        }
+    }
+}
+
+// Brings every section in InPreviousEdits up to the current edits. Sections are patched on the game thread until MaxImmediateEditVertices
+// is spent, so a small brush changes the surface and its collision the frame it is applied. The rest get an update job.
+void ALandscapeCore::RegenerateEditedSections(const TMap<FIntPoint, FLandscapeEditSnapshot>& InPreviousEdits)
+{
+    int32 ImmediateVertexBudget = MaxImmediateEditVertices;
+
+    for (const TPair<FIntPoint, FLandscapeEditSnapshot>& PreviousEdits : InPreviousEdits)
+    {
+        FChunkLocation SectionLocation(PreviousEdits.Key.X, PreviousEdits.Key.Y);
+        FLandscapeChunkRecord* ChunkRecord = FindChunkRecord(SectionLocation);
+        if (!ChunkRecord || !ChunkRecord->bGenerated)
+        {
+            continue;
+        }
+
+        int32 NumVertices = FMath::Square(GetSectionResolution(ChunkRecord->CurrentLODDepth) + 1);
+        if (NumVertices <= ImmediateVertexBudget && ApplySectionEditNow(PreviousEdits.Key, PreviousEdits.Value))
+        {
+            ImmediateVertexBudget -= NumVertices;
+            continue;
         }
+
+        // Foliage was placed on the old surface, The update commit places it again.
+        RemoveSectionFoliage(*ChunkRecord);
+        ChunkScheduler.Enqueue(PreviousEdits.Key, ChunkRecord->CurrentLODDepth, true);
+    }
+
+    FlushEditorSectionJobs();
+}
+
+// Patches a resident section with the difference between its current edits and InPreviousEdits, the ones it was built with,
+// so nothing is generated again. Returns false when the section has no resident heightfield or a job is in flight or queued for it,
+// A queued job picks the new edits up by itself.
+bool ALandscapeCore::ApplySectionEditNow(const FIntPoint& InChunk, const FLandscapeEditSnapshot& InPreviousEdits)
+{
+    FChunkLocation SectionLocation(InChunk.X, InChunk.Y);
+    FLandscapeChunkRecord* ChunkRecord = FindChunkRecord(SectionLocation);
+    if (!ChunkRecord || !ChunkRecord->bGenerated || !ChunkRecord->SectionMeshComponent || ChunkRecord->HasJobInFlight() || ChunkScheduler.Contains(InChunk))
+    {
+        return false;
+    }
+
+    FLandscapeHeightfieldTilePtr ResidentTile = HeightfieldStore ? HeightfieldStore->FindTile(InChunk) : nullptr;
+    URealtimeMeshSimple* RealtimeMesh = ChunkRecord->SectionMeshComponent->GetRealtimeMeshAs<URealtimeMeshSimple>();
+    if (!ResidentTile || !RealtimeMesh)
+    {
+        return false;
+    }
+
+    FLandscapeHeightfieldTile SectionTile = *ResidentTile;
+    TArray<FColor> VertexColors;
+    EditLayer.GetSnapshot(InChunk).ApplyToTile(SectionTile, &InPreviousEdits, VertexColors);
+
+    int32 Resolution = SectionTile.Resolution;
+    SectionTile.ApplyToRealtimeMesh(RealtimeMesh, GetSectionGroupKey(SectionLocation), *GetSectionTopology(Resolution), true,
+        FRealtimeMeshSectionConfig(ERealtimeMeshSectionDrawType::Static, 0), ChunkRecord->CollisionState == ELandscapeCollisionPolicy::Complex, VertexColors);
+    HeightfieldStore->SetTile(InChunk, MakeShared<const FLandscapeHeightfieldTile, ESPMode::ThreadSafe>(MoveTemp(SectionTile)), HeightfieldStore->GetGeneration());
+
+    // Simplified collision is resampled from the heightfield just published.
+    if (ChunkRecord->CollisionState == ELandscapeCollisionPolicy::Simplified)
+    {
+        ApplySectionCollision(SectionLocation, *ChunkRecord, ELandscapeCollisionPolicy::Simplified);
+    }
+
+    if (bStitchSectionEdges && bUseLODs)
+    {
+        CaptureSectionEdges(SectionLocation, Resolution);
+        RestitchSectionEdges(SectionLocation);
+    }
+
+    RemoveSectionFoliage(*ChunkRecord);
+    HandleSectionFoliage(SectionLocation, true);
+    return true;
+}
+
+
+
+// Edge Stitching
+
+// Reads a freshly built section back and records the vertices along each of its edges.
+// Edges are found from the position bounds so the capture does not depend on the vertex order the section was written in.
+void ALandscapeCore::CaptureSectionEdges(const FChunkLocation& InSectionLocation, int32 InResolution)
+{
+    FLandscapeChunkRecord* ChunkRecord = FindChunkRecord(InSectionLocation);
+    if (!ChunkRecord || !ChunkRecord->SectionMeshComponent)
+    {
         return;
     }
 
-    FVector WorldLocation = FVector(InLocation.X + GetActorLocation().X, InLocation.Y + GetActorLocation().Y, InLocation.Z);
-    TStrongObjectPtr<URealtimeMeshSimple> RealtimeMeshSimple = TStrongObjectPtr<URealtimeMeshSimple>(SectionRealtimeMeshComp->GetRealtimeMeshAs<URealtimeMeshSimple>());
+    URealtimeMeshSimple* RealtimeMesh = ChunkRecord->SectionMeshComponent->GetRealtimeMeshAs<URealtimeMeshSimple>();
+    if (!RealtimeMesh)
+    {
+        return;
+    }
 
-    TSharedPtr<LandscapeSectionData> LandscapeSection = MakeShared<LandscapeSectionData>(RealtimeMeshSimple.Get(), StreamSet, LandscapeNoiseParams, FChunkParams(
-        TerrainMaterial,                                           
-        SectionScale,                                              
-        AdjSubDivitions,                                           
-        SectionScale / AdjSubDivitions,                            
-        UVScale,                                                   
-        double(SectionScale * InVisibleChunk.XLocation),           
-        double(SectionScale * InVisibleChunk.YLocation)),          
-        BiomeBlender,
-        GetActorLocation(),
-        GetWorld(),
-        WorldXOffset,
-        WorldYOffset);
+    FSectionEdgeState EdgeState;
+    EdgeState.Resolution = InResolution;
+
+    RealtimeMesh->ProcessMesh(GetSectionGroupKey(InSectionLocation), [&EdgeState](const FRealtimeMeshStreamSet& Streams)
+        {
+            const FRealtimeMeshStream* PositionStream = Streams.Find(FRealtimeMeshStreams::Position);
+            if (!PositionStream)
+            {
+                return;
+            }
+
+            TRealtimeMeshStreamBuilder<const FVector3f> PositionBuilder(*PositionStream);
+            FBox2f Bounds(ForceInit);
+            for (int32 Index = 0; Index < PositionBuilder.Num(); ++Index)
+            {
+                FVector3f Position = PositionBuilder.Get(Index);
+                Bounds += FVector2f(Position.X, Position.Y);
+            }
 
-    ActiveGenerationDataMap.Add(InVisibleChunk, LandscapeSection);
-    SectionNode.CurrentLODDepth = InLodDepth;
-    ActiveSections.Emplace(InVisibleChunk, SectionNode);
-    
-    AsyncTask(ENamedThreads::AnyHiPriThreadHiPriTask, [this, LandscapeSection, InLocation, InVisibleChunk, SpawnSectionFolaige]()
-        {
-            LandscapeSection->UpdateSection();
+            // Read through a converting builder, The tangent precision depends on who built the section.
+            const FRealtimeMeshStream* TangentStream = Streams.Find(FRealtimeMeshStreams::Tangents);
+            TOptional<TRealtimeMeshStreamBuilder<const TRealtimeMeshTangents<FVector4f>, void>> TangentBuilder;
+            if (TangentStream && TangentStream->Num() == PositionBuilder.Num())
+            {
+                TangentBuilder.Emplace(*TangentStream);
+            }
+
+            float Tolerance = (Bounds.Max.X - Bounds.Min.X) / (FMath::Max(EdgeState.Resolution, 1) * 4.0f);
+            TArray<TPair<float, int32>> EdgeVertices[int32(ESectionEdge::Count)];
 
-            AsyncTask(ENamedThreads::GameThread, [this, InLocation, InVisibleChunk, SpawnSectionFolaige]()
+            for (int32 Index = 0; Index < PositionBuilder.Num(); ++Index)
+            {
+                FVector3f Position = PositionBuilder.Get(Index);
+                if (FMath::Abs(Position.X - Bounds.Min.X) <= Tolerance)
                 {
-                    FChunkLocation SectionLocation = InVisibleChunk;
-                    
-                    if (SpawnSectionFolaige)
-                    {
-                        HandleSectionFoliage(SectionLocation, true);
-                    }
-                    if (ActiveGenerationDataMap.Contains(SectionLocation))
+                    EdgeVertices[int32(ESectionEdge::West)].Add(TPair<float, int32>(Position.Y, Index));
+                }
+                if (FMath::Abs(Position.X - Bounds.Max.X) <= Tolerance)
+                {
+                    EdgeVertices[int32(ESectionEdge::East)].Add(TPair<float, int32>(Position.Y, Index));
+                }
+                if (FMath::Abs(Position.Y - Bounds.Min.Y) <= Tolerance)
+                {
+                    EdgeVertices[int32(ESectionEdge::South)].Add(TPair<float, int32>(Position.X, Index));
+                }
+                if (FMath::Abs(Position.Y - Bounds.Max.Y) <= Tolerance)
+                {
+                    EdgeVertices[int32(ESectionEdge::North)].Add(TPair<float, int32>(Position.X, Index));
+                }
+            }
+
+            for (int32 Edge = 0; Edge < int32(ESectionEdge::Count); Edge++)
+            {
+                EdgeVertices[Edge].Sort([](const TPair<float, int32>& A, const TPair<float, int32>& B) { return A.Key < B.Key; });
+
+                FSectionEdge& SectionEdge = EdgeState.Edges[Edge];
+                SectionEdge.StitchedResolution = EdgeState.Resolution;
+                for (const TPair<float, int32>& EdgeVertex : EdgeVertices[Edge])
+                {
+                    SectionEdge.VertexIndices.Add(EdgeVertex.Value);
+                    SectionEdge.GeneratedHeights.Add(PositionBuilder.Get(EdgeVertex.Value).Z);
+                    if (TangentBuilder.IsSet())
                     {
-                        ActiveGenerationDataMap.Remove(SectionLocation);
+                        SectionEdge.GeneratedNormals.Add(TangentBuilder->Get(EdgeVertex.Value).GetNormal());
                     }
-                });
+                }
+            }
         });
+
+    ChunkRecord->EdgeState = MoveTemp(EdgeState);
 }
 
-void ALandscapeCore::RemoveSections()
+// Re-stitches every edge the section shares with a neighbour, Each edge is only rewritten if the resolution it has to match changed.
+void ALandscapeCore::RestitchSectionEdges(const FChunkLocation& InSectionLocation)
+{
+    static const FIntPoint EdgeOffsets[int32(ESectionEdge::Count)] = { FIntPoint(-1, 0), FIntPoint(1, 0), FIntPoint(0, -1), FIntPoint(0, 1) };
+
+    for (int32 Edge = 0; Edge < int32(ESectionEdge::Count); Edge++)
+    {
+        FChunkLocation NeighbourLocation = FChunkLocation(InSectionLocation.XLocation + EdgeOffsets[Edge].X, InSectionLocation.YLocation + EdgeOffsets[Edge].Y);
+
+        StitchSectionEdge(InSectionLocation, Edge, NeighbourLocation);
+        StitchSectionEdge(NeighbourLocation, Edge ^ 1, InSectionLocation);
+    }
+}
+
+// The finer of two neighbouring sections bends its edge onto the coarser sections edge so the shared border has no cracks,
+// and takes the coarser sections normals along it so the lighting does not change across the border either.
+// If the neighbour is as fine or finer the edge is put back to the heights and normals it was generated with.
+// Sections with a job in flight are skipped, They are stitched when their own job commits.
+void ALandscapeCore::StitchSectionEdge(const FChunkLocation& InSectionLocation, int32 InEdge, const FChunkLocation& InNeighbourLocation)
 {
-    TArray<FChunkLocation> SectionsToRemove;
+    FLandscapeChunkRecord* ChunkRecord = FindChunkRecord(InSectionLocation);
+    FLandscapeChunkRecord* NeighbourRecord = FindChunkRecord(InNeighbourLocation);
+
+    if (!ChunkRecord || !NeighbourRecord || !ChunkRecord->EdgeState.IsCaptured() || !NeighbourRecord->EdgeState.IsCaptured() || ChunkRecord->HasJobInFlight())
+    {
+        return;
+    }
+
+    FSectionEdgeState* SectionState = &ChunkRecord->EdgeState;
+    const FSectionEdgeState* NeighbourState = &NeighbourRecord->EdgeState;
+
+    FSectionEdge& SectionEdge = SectionState->Edges[InEdge];
+    const FSectionEdge& NeighbourEdge = NeighbourState->Edges[InEdge ^ 1];
+    int32 TargetResolution = FMath::Min(SectionState->Resolution, NeighbourState->Resolution);
+
+    if (SectionEdge.StitchedResolution == TargetResolution || SectionEdge.GeneratedHeights.Num() < 2 || NeighbourEdge.GeneratedHeights.Num() < 2)
+    {
+        return;
+    }
+
+    TArray<float> EdgeHeights = SectionEdge.GeneratedHeights;
+    TArray<FVector3f> EdgeNormals = SectionEdge.GeneratedNormals;
+    bool bHasNormals = EdgeNormals.Num() == EdgeHeights.Num() && NeighbourEdge.GeneratedNormals.Num() == NeighbourEdge.GeneratedHeights.Num();
 
-    for (FChunkLocation Section : GeneratedChunks)
+    if (TargetResolution < SectionState->Resolution)
     {
-        if (!RenderedSections.Contains(Section))
+        int32 Segments = EdgeHeights.Num() - 1;
+        int32 NeighbourSegments = NeighbourEdge.GeneratedHeights.Num() - 1;
+
+        for (int32 i = 0; i <= Segments; i++)
         {
-            SectionsToRemove.Add(Section);
+            float Along = float(i) / Segments * NeighbourSegments;
+            int32 NeighbourIndex = FMath::Min(FMath::FloorToInt32(Along), NeighbourSegments - 1);
+            EdgeHeights[i] = FMath::Lerp(NeighbourEdge.GeneratedHeights[NeighbourIndex], NeighbourEdge.GeneratedHeights[NeighbourIndex + 1], Along - NeighbourIndex);
+            if (bHasNormals)
+            {
+                EdgeNormals[i] = FMath::Lerp(NeighbourEdge.GeneratedNormals[NeighbourIndex], NeighbourEdge.GeneratedNormals[NeighbourIndex + 1], Along - NeighbourIndex).GetSafeNormal(UE_SMALL_NUMBER, FVector3f::UpVector);
+            }
         }
     }
 
-    if (!SectionsToRemove.IsEmpty())
+    URealtimeMeshSimple* RealtimeMesh = ChunkRecord->SectionMeshComponent ? ChunkRecord->SectionMeshComponent->GetRealtimeMeshAs<URealtimeMeshSimple>() : nullptr;
+    if (!RealtimeMesh)
     {
-        TArray<FChunkLocation> MeshKeys;
-        ActiveSections.GetKeys(MeshKeys);
+        return;
+    }
 
-        for (auto MeshKey : MeshKeys)
+    const TArray<int32>& VertexIndices = SectionEdge.VertexIndices;
+    RealtimeMesh->EditMeshInPlace(GetSectionGroupKey(InSectionLocation), [&VertexIndices, &EdgeHeights, &EdgeNormals, bHasNormals](FRealtimeMeshStreamSet& Streams)
         {
-            if (SectionsToRemove.Contains(MeshKey))
+            TSet<FRealtimeMeshStreamKey> ModifiedStreams;
+            if (FRealtimeMeshStream* PositionStream = Streams.Find(FRealtimeMeshStreams::Position))
             {
-                URealtimeMeshComponent* RemoveMesh = ActiveSections[MeshKey].SectionMeshComponent;
-                APCGSectionFoliage* FoliageSection = nullptr;
-                if (FoliageSections.Contains(MeshKey))
-                {
-                    FoliageSection = *FoliageSections.Find(MeshKey);
-                }
-                else
+                TRealtimeMeshStreamBuilder<FVector3f> PositionBuilder(*PositionStream);
+                for (int32 i = 0; i < VertexIndices.Num(); i++)
                 {
-                    UE_LOG(LogTemp, Warning, TEXT("Could Not Find Foliage Section For Key : %d , $d"),MeshKey.XLocation, MeshKey.YLocation);
-                }
-               
-                if (RemoveMesh)
-                {
-                    GeneratedChunks.Remove(MeshKey);
-                    ActiveSections.Remove(MeshKey);
-                    RemoveMesh->DestroyComponent();
-                    if (FoliageSection)
-                    {
-                        FoliageSection->CleanUpFoliage();
-                        FoliageSection->Destroy();
-                    }
+                    FVector3f Position = PositionBuilder.Get(VertexIndices[i]);
+                    Position.Z = EdgeHeights[i];
+                    PositionBuilder.Set(VertexIndices[i], Position);
                 }
-                else
+                ModifiedStreams.Add(FRealtimeMeshStreams::Position);
+            }
+            FRealtimeMeshStream* TangentStream = Streams.Find(FRealtimeMeshStreams::Tangents);
+            if (bHasNormals && TangentStream)
+            {
+                TRealtimeMeshStreamBuilder<TRealtimeMeshTangents<FVector4f>, void> TangentBuilder(*TangentStream);
+                for (int32 i = 0; i < VertexIndices.Num(); i++)
                 {
-                    if (GEngine)
-                    {
-                        int32 XLocationtest = MeshKey.XLocation;
-                        int32 YLocationtest = MeshKey.YLocation;
-                        FString Message = FString::Printf(TEXT("Remove location was Null Ptr : X=%d, Y=%d"), XLocationtest, YLocationtest);
-                        GEngine->AddOnScreenDebugMessage(-1, 50.f, FColor::Red, Message);
-                    }
+                    TRealtimeMeshTangents<FVector4f> Tangents = TangentBuilder.Get(VertexIndices[i]);
+                    Tangents.SetNormal(EdgeNormals[i]);
+                    TangentBuilder.Set(VertexIndices[i], Tangents);
                 }
+                ModifiedStreams.Add(FRealtimeMeshStreams::Tangents);
             }
+            return ModifiedStreams;
+        });
+
+    SectionEdge.StitchedResolution = TargetResolution;
+
+    // Queries and simplified collision read the heightfield, So the resident tile takes the stitched edge too.
+    FIntPoint Chunk(InSectionLocation.XLocation, InSectionLocation.YLocation);
+    FLandscapeHeightfieldTilePtr ResidentTile = HeightfieldStore ? HeightfieldStore->FindTile(Chunk) : nullptr;
+    if (!ResidentTile || ResidentTile->Resolution != SectionState->Resolution || EdgeHeights.Num() != ResidentTile->GetVerticesPerSide())
+    {
+        return;
+    }
+
+    FLandscapeHeightfieldTile SectionTile = *ResidentTile;
+    int32 LastVertex = SectionTile.Resolution;
+    for (int32 i = 0; i < EdgeHeights.Num(); i++)
+    {
+        // Edge vertices were captured in ascending order along the edge, The same order as the grid.
+        int32 VertexIndex = 0;
+        switch (ESectionEdge(InEdge))
+        {
+        case ESectionEdge::West:  VertexIndex = SectionTile.GetVertexIndex(0, i); break;
+        case ESectionEdge::East:  VertexIndex = SectionTile.GetVertexIndex(LastVertex, i); break;
+        case ESectionEdge::South: VertexIndex = SectionTile.GetVertexIndex(i, 0); break;
+        default:                  VertexIndex = SectionTile.GetVertexIndex(i, LastVertex); break;
+        }
+
+        SectionTile.Heights[VertexIndex] = SectionTile.HeightQuantization.Encode(EdgeHeights[i]);
+        if (bHasNormals)
+        {
+            SectionTile.Normals[VertexIndex] = FLandscapeHeightfieldTile::EncodeNormal(EdgeNormals[i]);
         }
     }
-}
 
+    // Checked against the records token, A job issued after the edit was read publishes its own tile instead.
+    HeightfieldStore->SetTile(Chunk, MakeShared<const FLandscapeHeightfieldTile, ESPMode::ThreadSafe>(MoveTemp(SectionTile)), HeightfieldStore->GetGeneration(), ChunkRecord->JobToken.Get());
+
+    // Complex collision is cooked from the edited section, Simplified collision is resampled from the tile just published.
+    if (ChunkRecord->CollisionState == ELandscapeCollisionPolicy::Simplified)
+    {
+        ApplySectionCollision(InSectionLocation, *ChunkRecord, ELandscapeCollisionPolicy::Simplified);
+    }
+}
 
 
 // Helper Functions
 
+int32 ALandscapeCore::GetSectionResolution(int32 InLodDepth)
+{
+    if (bUseLODs && LODRingTable.IsValidLOD(InLodDepth))
+    {
+        return LODRingTable.GetResolution(InLodDepth);
+    }
+    return FMath::Max(SubDivitions, 4);
+}
+
 void ALandscapeCore::SetCurrentParams()
 {
     LandscapeNoiseParams.SetupNoise();
@@ -492,6 +2506,8 @@ void ALandscapeCore::SetCurrentParams()
         }
     }
     
+    ChunkCacheSignature = ComputeChunkCacheSignature();
+
     CurrentGeneratedParams = FGenerationParams(
         TerrainMaterial,
         SectionScale,
@@ -505,29 +2521,54 @@ void ALandscapeCore::SetCurrentParams()
     );
 }
 
+// Builds the Lod ring table from the Lod depths, Lookups after this are a single array index by Chebyshev distance.
 void ALandscapeCore::InitializeLODCache()
 {
-    LODCache.Empty();
+    LODRingTable.Reset();
+    InitializeTopologyCache();
 
     if (!bUseLODs || LodDepths.IsEmpty())
     {
         return;
     }
 
-    int32 GenerationDistance = GetGenerationDisantance();
-    
-    for (int32 XChunkIndex = GenerationDistance * -1; XChunkIndex <= GenerationDistance; XChunkIndex++)
+    for (int32 i = 0; i < LodDepths.Num(); i++)
+    {
+        LODRingTable.AddLOD(LodDepths[i].LODDistance, LodDepths[i].LODResolution, LodDepths[i].bLODSpawnFolaige, LodDepths[i].CollisionPolicy);
+    }
+    LODRingTable.Build();
+}
+
+// Builds the shared grid topology for every resolution a section can be generated at.
+// Sections that are still building keep their own reference so the old entries are safe to drop here.
+void ALandscapeCore::InitializeTopologyCache()
+{
+    SectionTopologyCache.Empty();
+    GetSectionTopology(SubDivitions);
+
+    if (bUseLODs)
     {
-        for (int32 YChunkIndex = GenerationDistance * -1; YChunkIndex <= GenerationDistance; YChunkIndex++)
+        for (int32 i = 0; i < LodDepths.Num(); i++)
         {
-            int32 AbsXChunkIndex = abs(XChunkIndex);
-            int32 AbsYChunkIndex = abs(YChunkIndex);
-           
-            GetLODForIndex(AbsXChunkIndex, AbsYChunkIndex);
+            GetSectionTopology(LodDepths[i].LODResolution);
         }
     }
 }
 
+FLandscapeSectionTopologyPtr ALandscapeCore::GetSectionTopology(int32 InLODResolution)
+{
+    TPair<int32, float> TopologyKey(InLODResolution, UVScale);
+
+    if (FLandscapeSectionTopologyPtr* CachedTopology = SectionTopologyCache.Find(TopologyKey))
+    {
+        return *CachedTopology;
+    }
+
+    FLandscapeSectionTopologyPtr NewTopology = MakeShared<const FLandscapeSectionTopology, ESPMode::ThreadSafe>(InLODResolution, UVScale);
+    SectionTopologyCache.Add(TopologyKey, NewTopology);
+    return NewTopology;
+}
+
 bool ALandscapeCore::CheckIfDirty()
 {
     FGenerationParams GenerationParams = FGenerationParams(
@@ -542,7 +2583,8 @@ bool ALandscapeCore::CheckIfDirty()
         LandscapeNoiseParams
     );
 
-    if (GenerationParams == CurrentGeneratedParams)
+    // World offsets and the height grid are not part of the generation params, They only show up in the signature.
+    if (GenerationParams == CurrentGeneratedParams && ComputeChunkCacheSignature() == ChunkCacheSignature)
     {
         return false;
     }
@@ -550,15 +2592,70 @@ bool ALandscapeCore::CheckIfDirty()
     return true;
 }
 
+// Hash of every input a sections heights depend on apart from its chunk coordinate and resolution.
+// The noise params are hashed through their exported property text so new noise settings are picked up without touching this function.
+uint64 ALandscapeCore::ComputeChunkCacheSignature()
+{
+    FString SignatureText;
+
+    if (FProperty* NoiseProperty = GetClass()->FindPropertyByName(GET_MEMBER_NAME_CHECKED(ALandscapeCore, LandscapeNoiseParams)))
+    {
+        NoiseProperty->ExportTextItem_Direct(SignatureText, &LandscapeNoiseParams, nullptr, this, PPF_None);
+    }
+    SignatureText += FString::Printf(TEXT("|%f|%f|%f|%f|%f|%f"), double(WorldXOffset), double(WorldYOffset), double(SectionScale), double(UVScale),
+        double(HeightQuantizationOrigin), double(HeightQuantizationStep));
+
+    FTCHARToUTF8 SignatureUTF8(*SignatureText);
+    return CityHash64(SignatureUTF8.Get(), SignatureUTF8.Length());
+}
+
+FLandscapeHeightQuantization ALandscapeCore::GetHeightQuantization() const
+{
+    FLandscapeHeightQuantization HeightQuantization;
+    HeightQuantization.Origin = HeightQuantizationOrigin;
+    HeightQuantization.Step = FMath::Max(HeightQuantizationStep, UE_KINDA_SMALL_NUMBER);
+    return HeightQuantization;
+}
+
 void ALandscapeCore::CleanUpLandscape()
 {
     bIsInitialized = false;
-    ActiveGenerationDataMap.Empty();
-    GeneratedChunks.Empty();
-    ActiveSections.Empty();
+    ChunkScheduler.Empty();
+    DrainWorkerQueues();
+    CommitStats = FLandscapeCommitStats();
+    StreamingTelemetry.Reset();
+    ChunkTable.ForEach([](const FIntPoint& InChunk, FLandscapeChunkRecord& InRecord)
+        {
+            if (InRecord.JobToken)
+            {
+                InRecord.JobToken->Cancel();
+            }
+        });
+    ChunkTable.Empty();
+    NumSectionJobsInFlight = 0;
     BiomeBlender = nullptr;
+    BiomePointCache = nullptr;
+    ChunkCache = nullptr;
+    BakedArchive = nullptr;
+    if (HeightfieldStore)
+    {
+        HeightfieldStore->Empty();
+    }
+    PrefetchedSections.Empty();
+    PrefetchWindows.Empty();
+    RenderedSections.Empty();
+    SectionDemands.Empty();
+    ViewerWindows.Empty();
+    PendingRemovals.Empty();
+    ActiveCollisionSections.Empty();
+    PriorityCollisionChunks.Empty();
+    CollisionWindows.Empty();
+    CollisionDemand.Empty();
+    PendingCollisionChunks.Empty();
     FlushPersistentDebugLines(GetWorld());
 
+    SectionComponentPool.Empty();
+
     TArray<USceneComponent*> AllMeshComps;
     this->GetRootComponent()->GetChildrenComponents(true, AllMeshComps);
     for (auto MeshComponent : AllMeshComps)
@@ -576,7 +2673,29 @@ void ALandscapeCore::CleanUpLandscape()
             Section->Destroy();
         }
     }
-    FoliageSections.Empty();
+}
+
+// Throws away everything workers have queued so far, Workers may still be running and queue more,
+// so the counters are decremented per result taken off rather than reset and stay in step with the queues.
+void ALandscapeCore::DrainWorkerQueues()
+{
+    FCompletedSectionJob CompletedJob;
+    while (CompletedSectionQueue.Dequeue(CompletedJob))
+    {
+        NumQueuedCommits--;
+    }
+
+    TPair<FChunkLocation, UDynamicMesh*> SpawnTask;
+    while (FoliageSpawnQueue.Dequeue(SpawnTask))
+    {
+        NumQueuedFoliageSpawns--;
+    }
+
+    FLandscapeFoliageBatch FoliageBatch;
+    while (FoliageBatchQueue.Dequeue(FoliageBatch))
+    {
+        NumQueuedFoliageSpawns--;
+    }
 }
 
 int32 ALandscapeCore::GetGenerationDisantance()
@@ -604,27 +2723,91 @@ int32 ALandscapeCore::GetGenerationDisantance()
 
 int32 ALandscapeCore::GetLODForIndex(int32 InXIndex, int32 InYIndex)
 {
-    TPair<int32, int32> IndexPair(InXIndex, InYIndex);
+    return LODRingTable.GetLODForIndex(InXIndex, InYIndex);
+}
 
-    if (LODCache.Contains(IndexPair))
+// Lod depth for a chunk InXIndex, InYIndex chunks away from a viewer with the viewers Lod bias applied.
+int32 ALandscapeCore::GetViewerLODForIndex(int32 InLODBias, int32 InXIndex, int32 InYIndex)
+{
+    if (!bUseLODs || LODRingTable.IsEmpty())
     {
-        return LODCache[IndexPair];
+        return 0;
     }
+    return FMath::Clamp(LODRingTable.GetLODForIndex(InXIndex, InYIndex) + InLODBias, 0, LODRingTable.Num() - 1);
+}
+
+FLandscapeChunkRecord* ALandscapeCore::FindChunkRecord(const FChunkLocation& InLocation)
+{
+    return ChunkTable.Find(FIntPoint(InLocation.XLocation, InLocation.YLocation));
+}
 
-    int32 MaxGenerationDistance = FMath::Max(InXIndex, InYIndex);
-    int32 CumulativeGenerationDistance = 0;
+FLandscapeChunkRecord& ALandscapeCore::FindOrAddChunkRecord(const FChunkLocation& InLocation)
+{
+    return ChunkTable.FindOrAdd(FIntPoint(InLocation.XLocation, InLocation.YLocation));
+}
 
-    for (int32 i = 0; i < LodDepths.Num(); i++)
+void ALandscapeCore::RemoveChunkRecord(const FChunkLocation& InLocation)
+{
+    ChunkTable.Remove(FIntPoint(InLocation.XLocation, InLocation.YLocation));
+}
+
+bool ALandscapeCore::IsChunkGenerated(const FChunkLocation& InLocation)
+{
+    const FLandscapeChunkRecord* ChunkRecord = FindChunkRecord(InLocation);
+    return ChunkRecord && ChunkRecord->bGenerated;
+}
+
+// Normalizes a world space location to the root component of the landscape and returns the chunk it falls in.
+FChunkLocation ALandscapeCore::GetChunkForLocation(const FVector& InLocation)
+{
+    FVector NormalizedtLocation = InLocation - GetActorLocation();
+    return FChunkLocation(FMath::TruncToInt32(NormalizedtLocation.X / SectionScale), FMath::TruncToInt32(NormalizedtLocation.Y / SectionScale));
+}
+
+void ALandscapeCore::RemoveSectionHeightfield(const FChunkLocation& InLocation)
+{
+    if (HeightfieldStore)
     {
-        CumulativeGenerationDistance += LodDepths[i].LODDistance;
+        HeightfieldStore->RemoveTile(FIntPoint(InLocation.XLocation, InLocation.YLocation));
+    }
+}
 
-        if (MaxGenerationDistance <= CumulativeGenerationDistance)
-        {
-            LODCache.Add(IndexPair, i);
-            return i;
-        }
+// Height queries
+
+// Safe to call from any thread, Samples the heightfield of the resident section under the location.
+// Returns false when the location is outside every generated section.
+bool ALandscapeCore::SampleHeight(const FVector& InWorldLocation, float& OutHeight) const
+{
+    return HeightfieldStore && HeightfieldStore->SampleHeight(InWorldLocation, OutHeight);
+}
+
+bool ALandscapeCore::SampleNormal(const FVector& InWorldLocation, FVector& OutNormal) const
+{
+    return HeightfieldStore && HeightfieldStore->SampleNormal(InWorldLocation, OutNormal);
+}
+
+int32 ALandscapeCore::SampleHeights(const TArray<FVector>& InWorldLocations, TArray<float>& OutHeights, TArray<bool>& OutValid) const
+{
+    if (!HeightfieldStore)
+    {
+        OutHeights.SetNumZeroed(InWorldLocations.Num());
+        OutValid.Init(false, InWorldLocations.Num());
+        return 0;
     }
-    return LodDepths.Num() - 1;
+    return HeightfieldStore->SampleHeights(InWorldLocations, OutHeights, OutValid);
+}
+
+// Section groups are keyed by chunk location, Matches the key LandscapeSectionData builds the section under.
+FRealtimeMeshSectionGroupKey ALandscapeCore::GetSectionGroupKey(const FChunkLocation& InLocation)
+{
+    FString FormattedString = FString::Printf(TEXT("FaceID_%d_%d"), InLocation.XLocation, InLocation.YLocation);
+    return FRealtimeMeshSectionGroupKey::Create(0, FName(*FormattedString));
+}
+
+FRealtimeMeshSectionGroupKey ALandscapeCore::GetSectionCollisionGroupKey(const FChunkLocation& InLocation)
+{
+    FString FormattedString = FString::Printf(TEXT("CollisionID_%d_%d"), InLocation.XLocation, InLocation.YLocation);
+    return FRealtimeMeshSectionGroupKey::Create(0, FName(*FormattedString));
 }
 
 int32 ALandscapeCore::RoundToNearestMultipleOfFour(int32 InValue)
@@ -647,15 +2830,11 @@ int32 ALandscapeCore::RoundToNearestMultipleOfFour(int32 InValue)
 void ALandscapeCore::MakeDynamicMeshProxy(const FChunkLocation InLocation)
 {
     
-    FString FormattedString = FString::Printf(TEXT("FaceID_%d_%d"), InLocation.XLocation, InLocation.YLocation);
-
-    FName FaceKey = FName(*FormattedString);
-
-    FRealtimeMeshSectionGroupKey GroupKey = FRealtimeMeshSectionGroupKey::Create(0, FaceKey);
+    FRealtimeMeshSectionGroupKey GroupKey = GetSectionGroupKey(InLocation);
 
     TObjectPtr<UDynamicMesh> DynamicMesh = NewObject<UDynamicMesh>();
     
-    auto RealtimeMeshComp = ActiveSections.Find(InLocation)->SectionMeshComponent;
+    auto RealtimeMeshComp = FindChunkRecord(InLocation)->SectionMeshComponent;
     auto RealtimeMesh = RealtimeMeshComp->GetRealtimeMeshAs<URealtimeMeshSimple>();
 
     if (RealtimeMesh == nullptr)
@@ -697,34 +2876,182 @@ void ALandscapeCore::MakeDynamicMeshProxy(const FChunkLocation InLocation)
 
             if (bSuccess)
             {
-                
-                AsyncTask(ENamedThreads::GameThread, [this, InLocation, AsyncDynamicMesh]()
-                    {
-                        if (GIsEditor)
+                if (GIsEditor)
+                {
+                    AsyncTask(ENamedThreads::GameThread, [this, InLocation, AsyncDynamicMesh]()
                         {
                             SpawnFolaigeSection(InLocation, AsyncDynamicMesh);
-                        }
-                        else
-                        {
-                            FoliageSpawnQueue.Enqueue(TPair<FChunkLocation, UDynamicMesh*>(InLocation, AsyncDynamicMesh));
-                        }
-                    });
+                        });
+                }
+                else
+                {
+                    // Spawned by the commit stage in Tick within its time budget.
+                    NumQueuedFoliageSpawns++;
+                    FoliageSpawnQueue.Enqueue(TPair<FChunkLocation, UDynamicMesh*>(InLocation, AsyncDynamicMesh));
+                }
             }
         });
 }
 
-void ALandscapeCore::ProcessFoliageQueue()
+// Spawns queued foliage sections and adds queued instance batches until InDeadline, Always at least one, Returns the number processed.
+int32 ALandscapeCore::ProcessFoliageQueue(double InDeadline)
 {
     TPair<FChunkLocation, UDynamicMesh*> SpawnTask;
-    if (FoliageSpawnQueue.Dequeue(SpawnTask))
+    FLandscapeFoliageBatch FoliageBatch;
+    int32 Spawned = 0;
+
+    while ((Spawned == 0 || FPlatformTime::Seconds() < InDeadline) && FoliageSpawnQueue.Dequeue(SpawnTask))
     {
+        NumQueuedFoliageSpawns--;
         SpawnFolaigeSection(SpawnTask.Key, SpawnTask.Value);
+        Spawned++;
+    }
+    while ((Spawned == 0 || FPlatformTime::Seconds() < InDeadline) && FoliageBatchQueue.Dequeue(FoliageBatch))
+    {
+        NumQueuedFoliageSpawns--;
+        AddFoliageBatch(FoliageBatch);
+        Spawned++;
+    }
+    return Spawned;
+}
+
+// Places the sections foliage on a worker from the heightfield its job published and the biome blend weights,
+// The instances come back in batches through FoliageBatchQueue and are added by the commit stage within its time budget.
+void ALandscapeCore::RequestSectionFoliageInstances(const FChunkLocation& InLocation)
+{
+    FLandscapeChunkRecord* ChunkRecord = FindChunkRecord(InLocation);
+    if (!ChunkRecord || !ChunkRecord->bGenerated || !ChunkRecord->SectionMeshComponent || FoliageLayers.IsEmpty() || !HeightfieldStore)
+    {
+        return;
+    }
+
+    FIntPoint Chunk(InLocation.XLocation, InLocation.YLocation);
+    FLandscapeHeightfieldTilePtr SectionTile = HeightfieldStore->FindTile(Chunk);
+    if (!SectionTile)
+    {
+        return;
+    }
+
+    ChunkRecord->FoliageRequestId = ++NextFoliageRequestId;
+
+    FVector2D NoiseOffset(double(SectionScale) * Chunk.X + WorldXOffset, double(SectionScale) * Chunk.Y + WorldYOffset);
+    bool bAddImmediately = !GetWorld()->IsGameWorld();
+
+    AsyncTask(ENamedThreads::AnyBackgroundThreadNormalTask, [this, SectionTile, Chunk, NoiseOffset, Layers = FoliageLayers, PointCache = BiomePointCache, Archive = BakedArchive,
+        RequestId = ChunkRecord->FoliageRequestId, BatchSize = FoliageBatchSize, bAddImmediately]()
+        {
+            TArray<FLandscapeFoliageBatch> Batches;
+            TArray<float> BakedBiomeWeights;
+            uint32 FoliageSeed = 0;
+            if (Archive && Archive->LoadFoliageInputs(Chunk, SectionTile->Resolution, BakedBiomeWeights, FoliageSeed))
+            {
+                FLandscapeFoliagePlacement::PlaceSectionInstances(*SectionTile, Chunk, Layers, BakedBiomeWeights, Archive->GetNumBiomes(), FoliageSeed, RequestId, BatchSize, Batches);
+            }
+            else
+            {
+                FLandscapeFoliagePlacement::PlaceSectionInstances(*SectionTile, Chunk, NoiseOffset, Layers, PointCache.Get(), RequestId, BatchSize, Batches);
+            }
+
+            for (FLandscapeFoliageBatch& Batch : Batches)
+            {
+                NumQueuedFoliageSpawns++;
+                FoliageBatchQueue.Enqueue(MoveTemp(Batch));
+            }
+
+            if (bAddImmediately && !Batches.IsEmpty())
+            {
+                AsyncTask(ENamedThreads::GameThread, [this]()
+                    {
+                        ProcessFoliageQueue(MAX_dbl);
+                    });
+            }
+        });
+}
+
+void ALandscapeCore::AddFoliageBatch(const FLandscapeFoliageBatch& InBatch)
+{
+    LANDSCAPE_SCOPE(STAT_LandscapeFoliageSpawn);
+
+    // The section may have been removed, or its foliage requested again, while the batch was being placed.
+    FLandscapeChunkRecord* ChunkRecord = FindChunkRecord(FChunkLocation(InBatch.Chunk.X, InBatch.Chunk.Y));
+    if (!ChunkRecord || ChunkRecord->FoliageRequestId != InBatch.RequestId || !ChunkRecord->SectionMeshComponent || !FoliageLayers.IsValidIndex(InBatch.LayerIndex))
+    {
+        return;
+    }
+
+    if (ChunkRecord->FoliageComponents.Num() <= InBatch.LayerIndex)
+    {
+        ChunkRecord->FoliageComponents.SetNumZeroed(FoliageLayers.Num());
+    }
+
+    UHierarchicalInstancedStaticMeshComponent*& FoliageComponent = ChunkRecord->FoliageComponents[InBatch.LayerIndex];
+    if (!FoliageComponent)
+    {
+        const FLandscapeFoliageLayer& Layer = FoliageLayers[InBatch.LayerIndex];
+        FoliageComponent = NewObject<UHierarchicalInstancedStaticMeshComponent>(this);
+        FoliageComponent->SetStaticMesh(Layer.Mesh);
+        FoliageComponent->SetCollisionEnabled(Layer.bEnableCollision ? ECollisionEnabled::QueryAndPhysics : ECollisionEnabled::NoCollision);
+        FoliageComponent->SetCullDistances(0, Layer.CullDistance);
+        FoliageComponent->RegisterComponent();
+        FoliageComponent->AttachToComponent(ChunkRecord->SectionMeshComponent, FAttachmentTransformRules::KeepRelativeTransform);
+    }
+
+    // The section may have been rebuilt at another Lod depth since the batch was placed, Its instances go on the surface it has now.
+    TArray<FTransform> Transforms = InBatch.Transforms;
+    if (FLandscapeHeightfieldTilePtr SectionTile = HeightfieldStore ? HeightfieldStore->FindTile(InBatch.Chunk) : nullptr)
+    {
+        FLandscapeFoliagePlacement::ProjectToSurface(*SectionTile, Transforms);
+    }
+    FoliageComponent->AddInstances(Transforms, false);
+}
+
+// Moves the instances already added to a rebuilt section onto its new surface, So they neither float above nor sink into a section whose Lod changed.
+void ALandscapeCore::ProjectSectionFoliage(const FChunkLocation& InLocation, FLandscapeChunkRecord& InChunkRecord)
+{
+    FLandscapeHeightfieldTilePtr SectionTile = HeightfieldStore ? HeightfieldStore->FindTile(FIntPoint(InLocation.XLocation, InLocation.YLocation)) : nullptr;
+    if (!SectionTile)
+    {
+        return;
+    }
+
+    TArray<FTransform> Transforms;
+    for (UHierarchicalInstancedStaticMeshComponent* FoliageComponent : InChunkRecord.FoliageComponents)
+    {
+        if (!IsValid(FoliageComponent) || FoliageComponent->GetInstanceCount() == 0)
+        {
+            continue;
+        }
+
+        Transforms.SetNum(FoliageComponent->GetInstanceCount(), false);
+        for (int32 InstanceIndex = 0; InstanceIndex < Transforms.Num(); InstanceIndex++)
+        {
+            FoliageComponent->GetInstanceTransform(InstanceIndex, Transforms[InstanceIndex], false);
+        }
+        FLandscapeFoliagePlacement::ProjectToSurface(*SectionTile, Transforms);
+        FoliageComponent->BatchUpdateInstancesTransforms(0, Transforms, false, true);
+    }
+}
+
+void ALandscapeCore::RemoveSectionFoliageInstances(FLandscapeChunkRecord& InChunkRecord)
+{
+    for (UHierarchicalInstancedStaticMeshComponent* FoliageComponent : InChunkRecord.FoliageComponents)
+    {
+        if (IsValid(FoliageComponent))
+        {
+            FoliageComponent->DestroyComponent();
+        }
     }
+    InChunkRecord.FoliageComponents.Empty();
+    InChunkRecord.FoliageRequestId = 0;
 }
 
 void ALandscapeCore::SpawnFolaigeSection(const FChunkLocation InLocation, UDynamicMesh* InDynamicMesh)
 {
-    if (InDynamicMesh && bSpawnFoliageSections)
+    LANDSCAPE_SCOPE(STAT_LandscapeFoliageSpawn);
+
+    // The section may have been removed while its foliage mesh was being converted.
+    FLandscapeChunkRecord* ChunkRecord = FindChunkRecord(InLocation);
+    if (InDynamicMesh && bSpawnFoliageSections && ChunkRecord && ChunkRecord->bGenerated)
     {
         FVector WorldLocation = FVector((InLocation.XLocation * SectionScale) + GetActorLocation().X, (InLocation.YLocation * SectionScale) + GetActorLocation().Y, GetActorLocation().Z);
         FRotator Rotation(0.0f, 0.0f, 0.0f);
@@ -733,31 +3060,45 @@ void ALandscapeCore::SpawnFolaigeSection(const FChunkLocation InLocation, UDynam
         if (APCGSectionFoliage* FoliageActor = GetWorld()->SpawnActor<APCGSectionFoliage>(FoliageGenerator, WorldLocation, Rotation, SpawnInfo))
         {
             FoliageActor->InitializeSectionFoliage(WorldLocation, InDynamicMesh);
-            FoliageSections.Add(InLocation, FoliageActor);
+            ChunkRecord->FoliageSection = FoliageActor;
         }
     }
 }
 
+// Foliage is placed from the heightfield when bUseHeightfieldFoliage is set, Otherwise the section mesh is converted for the PCG foliage actor.
 void ALandscapeCore::HandleSectionFoliage(const FChunkLocation InLocation, bool bIsUpdate)
 {
 
     if (bIsUpdate)
     {
-        FSectionNode SectionNode = *ActiveSections.Find(InLocation);
+        FLandscapeChunkRecord* ChunkRecord = FindChunkRecord(InLocation);
 
-        if (SectionNode.SectionMeshComponent)
+        if (ChunkRecord && ChunkRecord->SectionMeshComponent)
         {
-            int32 LodDepth = SectionNode.CurrentLODDepth;
+            int32 LodDepth = ChunkRecord->CurrentLODDepth;
 
-            if (LodDepths[LodDepth].bLODSpawnFolaige)
+            if (LODRingTable.ShouldSpawnFoliage(LodDepth))
             {
-                if (!FoliageSections.Contains(InLocation))
+                if (bUseHeightfieldFoliage && ChunkRecord->FoliageRequestId == 0)
+                {
+                    RequestSectionFoliageInstances(InLocation);
+                }
+                else if (bUseHeightfieldFoliage)
+                {
+                    // Batches still being placed are projected as they are added.
+                    ProjectSectionFoliage(InLocation, *ChunkRecord);
+                }
+                else if (!bUseHeightfieldFoliage && !ChunkRecord->FoliageSection.IsValid())
                 {
                     MakeDynamicMeshProxy(InLocation);
                 }
             }
         }
     }
+    else if (bUseHeightfieldFoliage)
+    {
+        RequestSectionFoliageInstances(InLocation);
+    }
     else
     {
         MakeDynamicMeshProxy(InLocation);
@@ -784,11 +3125,10 @@ TArray<FVector3f> ALandscapeCore::GetVertexPositions(FChunkLocation InSectionLoc
 {
 
     TArray<FVector3f> Positions;
-    auto RealtimeMeshComp = ActiveSections.Find(InSectionLocation)->SectionMeshComponent;
+    auto RealtimeMeshComp = FindChunkRecord(InSectionLocation)->SectionMeshComponent;
     auto RealtimeMesh = RealtimeMeshComp->GetRealtimeMeshAs<URealtimeMeshSimple>();
 
-    FName FaceKey = FName(*FString::Printf(TEXT("FaceID_%f_%f"), InSectionLocation.XLocation, InSectionLocation.YLocation));
-    FRealtimeMeshSectionGroupKey GroupKey = FRealtimeMeshSectionGroupKey::Create(0, FaceKey);
+    FRealtimeMeshSectionGroupKey GroupKey = GetSectionGroupKey(InSectionLocation);
    
 
     RealtimeMesh->ProcessMesh(GroupKey, [&Positions](const FRealtimeMeshStreamSet& Streams)
@@ -0,0 +1,637 @@
+// Copyright 2024 Samuel Freeman All rights reserved.
+
+
+#include "Framework/LandscapeEditLayer.h"
+#include "Framework/LandscapeHeightfield.h"
+#include "Framework/LandscapeHeightfieldStore.h"
+#include "Framework/LandscapeStreamingStats.h"
+#include "Misc/Compression.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+
+namespace LandscapeEditLayer
+{
+    static constexpr uint32 FileMagic = 0x3145544C; // "LTE1"
+    static constexpr uint32 FileVersion = 2;
+
+    // Every height delta is a whole number of these (cm), The same for the whole layer so tiles never disagree on a shared sample.
+    static constexpr float DeltaStep = 0.01f;
+
+    static int32 EncodeDelta(float InDelta) { return FMath::RoundToInt32(InDelta / DeltaStep); }
+    static float DecodeDelta(int32 InEncodedDelta) { return float(InEncodedDelta) * DeltaStep; }
+
+    // The crater rim rises outside the radius and is back to zero at CraterRimEnd radii.
+    static constexpr float CraterRimEnd = 1.3f;
+    static constexpr float CraterRimHeight = 0.2f;
+
+    // Upper bound on a decompressed layer, Anything larger is treated as corrupt.
+    static constexpr int32 MaxRawSize = 256 * 1024 * 1024;
+
+    // Compressed data is prefixed with the raw size, A negative size marks data that did not compress and is stored as is.
+    static void CompressData(const TArray<uint8>& InRawData, TArray<uint8>& OutData)
+    {
+        int32 RawSize = InRawData.Num();
+        int32 CompressedSize = FCompression::CompressMemoryBound(NAME_Zlib, RawSize);
+        OutData.SetNumUninitialized(sizeof(int32) + CompressedSize);
+
+        if (FCompression::CompressMemory(NAME_Zlib, OutData.GetData() + sizeof(int32), CompressedSize, InRawData.GetData(), RawSize) && CompressedSize < RawSize)
+        {
+            FMemory::Memcpy(OutData.GetData(), &RawSize, sizeof(int32));
+            OutData.SetNum(sizeof(int32) + CompressedSize, false);
+            return;
+        }
+
+        int32 StoredSize = -RawSize;
+        OutData.SetNumUninitialized(sizeof(int32) + RawSize);
+        FMemory::Memcpy(OutData.GetData(), &StoredSize, sizeof(int32));
+        FMemory::Memcpy(OutData.GetData() + sizeof(int32), InRawData.GetData(), RawSize);
+    }
+
+    static bool DecompressData(TConstArrayView<uint8> InData, TArray<uint8>& OutRawData)
+    {
+        if (InData.Num() < int32(sizeof(int32)))
+        {
+            return false;
+        }
+
+        int32 RawSize;
+        FMemory::Memcpy(&RawSize, InData.GetData(), sizeof(int32));
+        const uint8* Payload = InData.GetData() + sizeof(int32);
+        int32 PayloadSize = InData.Num() - sizeof(int32);
+
+        if (RawSize < 0)
+        {
+            if (-RawSize != PayloadSize)
+            {
+                return false;
+            }
+            OutRawData = TArray<uint8>(Payload, PayloadSize);
+            return true;
+        }
+
+        if (RawSize > MaxRawSize)
+        {
+            return false;
+        }
+        OutRawData.SetNumUninitialized(RawSize);
+        return FCompression::UncompressMemory(NAME_Zlib, OutRawData.GetData(), RawSize, Payload, PayloadSize);
+    }
+
+    // Full strength inside the hardness radius, Smoothly down to zero at the radius.
+    static float GetBrushWeight(float InDistance, float InRadius, float InHardness)
+    {
+        float InnerRadius = InRadius * FMath::Clamp(InHardness, 0.0f, 1.0f);
+        if (InDistance <= InnerRadius)
+        {
+            return 1.0f;
+        }
+        if (InDistance >= InRadius)
+        {
+            return 0.0f;
+        }
+        return 1.0f - FMath::SmoothStep(InnerRadius, InRadius, InDistance);
+    }
+
+    // Depth of the crater at InDistance radii from its center, in units of the stroke strength.
+    static float GetCraterProfile(float InDistance)
+    {
+        if (InDistance < 1.0f)
+        {
+            return -(1.0f - FMath::Square(InDistance));
+        }
+        if (InDistance < CraterRimEnd)
+        {
+            return CraterRimHeight * FMath::Sin(PI * (InDistance - 1.0f) / (CraterRimEnd - 1.0f));
+        }
+        return 0.0f;
+    }
+
+    static FColor LerpColor(const FColor& InFrom, const FColor& InTo, float InAlpha)
+    {
+        return FColor(
+            uint8(FMath::RoundToInt32(FMath::Lerp(float(InFrom.R), float(InTo.R), InAlpha))),
+            uint8(FMath::RoundToInt32(FMath::Lerp(float(InFrom.G), float(InTo.G), InAlpha))),
+            uint8(FMath::RoundToInt32(FMath::Lerp(float(InFrom.B), float(InTo.B), InAlpha))),
+            uint8(FMath::RoundToInt32(FMath::Lerp(float(InFrom.A), float(InTo.A), InAlpha))));
+    }
+}
+
+// Edit Tile
+
+void FLandscapeEditTile::Quantize()
+{
+    for (float& Delta : HeightDeltas)
+    {
+        Delta = LandscapeEditLayer::DecodeDelta(LandscapeEditLayer::EncodeDelta(Delta));
+    }
+}
+
+void FLandscapeEditTile::Write(FArchive& Ar, int32 InResolution) const
+{
+    check(HeightDeltas.Num() == FMath::Square(InResolution + 1));
+
+    // Untouched samples are all zero, so a mostly unedited tile compresses to almost nothing.
+    TArray<int32> EncodedDeltas;
+    EncodedDeltas.SetNumUninitialized(HeightDeltas.Num());
+    for (int32 Index = 0; Index < HeightDeltas.Num(); Index++)
+    {
+        EncodedDeltas[Index] = LandscapeEditLayer::EncodeDelta(HeightDeltas[Index]);
+    }
+
+    uint32 TileRevision = Revision;
+    bool bHasPaint = !Paint.IsEmpty();
+    Ar << TileRevision << EncodedDeltas << bHasPaint;
+    if (bHasPaint)
+    {
+        TArray<FColor> TilePaint = Paint;
+        Ar << TilePaint;
+    }
+}
+
+bool FLandscapeEditTile::Read(FArchive& Ar, int32 InResolution)
+{
+    int32 NumSamples = FMath::Square(InResolution + 1);
+    TArray<int32> EncodedDeltas;
+    bool bHasPaint = false;
+
+    Ar << Revision << EncodedDeltas << bHasPaint;
+    Paint.Empty();
+    if (bHasPaint)
+    {
+        Ar << Paint;
+    }
+
+    if (Ar.IsError() || EncodedDeltas.Num() != NumSamples || (bHasPaint && Paint.Num() != NumSamples))
+    {
+        return false;
+    }
+
+    HeightDeltas.SetNumUninitialized(NumSamples);
+    for (int32 Index = 0; Index < NumSamples; Index++)
+    {
+        HeightDeltas[Index] = LandscapeEditLayer::DecodeDelta(EncodedDeltas[Index]);
+    }
+    return true;
+}
+
+// Edit Snapshot
+
+bool FLandscapeEditSnapshot::IsEmpty() const
+{
+    for (const FLandscapeEditTilePtr& Tile : Tiles)
+    {
+        if (Tile)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool FLandscapeEditSnapshot::HasPaint() const
+{
+    for (const FLandscapeEditTilePtr& Tile : Tiles)
+    {
+        if (Tile && !Tile->Paint.IsEmpty())
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+const FLandscapeEditTile* FLandscapeEditSnapshot::FindTile(const FVector2D& InPosition, FVector2D& OutGridPosition) const
+{
+    if (SectionScale <= 0.0f || Resolution <= 0)
+    {
+        return nullptr;
+    }
+
+    int32 TileX = FMath::FloorToInt32(InPosition.X / SectionScale);
+    int32 TileY = FMath::FloorToInt32(InPosition.Y / SectionScale);
+    int32 SlotX = TileX - Chunk.X + 1;
+    int32 SlotY = TileY - Chunk.Y + 1;
+    if (SlotX < 0 || SlotY < 0 || SlotX > 2 || SlotY > 2)
+    {
+        return nullptr;
+    }
+
+    OutGridPosition = FVector2D(InPosition.X / SectionScale - TileX, InPosition.Y / SectionScale - TileY) * Resolution;
+    return Tiles[SlotX * 3 + SlotY].Get();
+}
+
+float FLandscapeEditSnapshot::SampleHeightDelta(const FVector2D& InPosition) const
+{
+    FVector2D GridPosition;
+    const FLandscapeEditTile* Tile = FindTile(InPosition, GridPosition);
+    if (!Tile)
+    {
+        return 0.0f;
+    }
+
+    int32 CellX = FMath::Clamp(FMath::FloorToInt32(GridPosition.X), 0, Resolution - 1);
+    int32 CellY = FMath::Clamp(FMath::FloorToInt32(GridPosition.Y), 0, Resolution - 1);
+    float FracX = FMath::Clamp(float(GridPosition.X - CellX), 0.0f, 1.0f);
+    float FracY = FMath::Clamp(float(GridPosition.Y - CellY), 0.0f, 1.0f);
+
+    int32 Index00 = CellX * (Resolution + 1) + CellY;
+    int32 Index10 = Index00 + Resolution + 1;
+    return FMath::BiLerp(Tile->HeightDeltas[Index00], Tile->HeightDeltas[Index10], Tile->HeightDeltas[Index00 + 1], Tile->HeightDeltas[Index10 + 1], FracX, FracY);
+}
+
+FColor FLandscapeEditSnapshot::SamplePaint(const FVector2D& InPosition) const
+{
+    FVector2D GridPosition;
+    const FLandscapeEditTile* Tile = FindTile(InPosition, GridPosition);
+    if (!Tile || Tile->Paint.IsEmpty())
+    {
+        return FColor::White;
+    }
+
+    int32 CellX = FMath::Clamp(FMath::FloorToInt32(GridPosition.X), 0, Resolution - 1);
+    int32 CellY = FMath::Clamp(FMath::FloorToInt32(GridPosition.Y), 0, Resolution - 1);
+    float FracX = FMath::Clamp(float(GridPosition.X - CellX), 0.0f, 1.0f);
+    float FracY = FMath::Clamp(float(GridPosition.Y - CellY), 0.0f, 1.0f);
+
+    int32 Index00 = CellX * (Resolution + 1) + CellY;
+    int32 Index10 = Index00 + Resolution + 1;
+    FColor Bottom = LandscapeEditLayer::LerpColor(Tile->Paint[Index00], Tile->Paint[Index10], FracX);
+    FColor Top = LandscapeEditLayer::LerpColor(Tile->Paint[Index00 + 1], Tile->Paint[Index10 + 1], FracX);
+    return LandscapeEditLayer::LerpColor(Bottom, Top, FracY);
+}
+
+void FLandscapeEditSnapshot::ApplyToTile(FLandscapeHeightfieldTile& InOutTile, const FLandscapeEditSnapshot* InPreviousEdits, TArray<FColor>& OutVertexColors) const
+{
+    LANDSCAPE_SCOPE(STAT_LandscapeApplyEdits);
+
+    OutVertexColors.Reset();
+    if (!InOutTile.IsValid() || (IsEmpty() && (!InPreviousEdits || InPreviousEdits->IsEmpty())))
+    {
+        return;
+    }
+
+    int32 NumVertices = InOutTile.Heights.Num();
+    bool bPainted = HasPaint();
+    if (bPainted)
+    {
+        OutVertexColors.SetNumUninitialized(NumVertices);
+    }
+
+    TArray<uint16> Heights;
+    Heights.SetNumUninitialized(NumVertices);
+    bool bHeightsChanged = false;
+
+    float Step = InOutTile.GetStep();
+    FVector2D SectionOrigin(double(SectionScale) * Chunk.X + InOutTile.Origin.X, double(SectionScale) * Chunk.Y + InOutTile.Origin.Y);
+    auto SampleEditDelta = [this, InPreviousEdits](const FVector2D& InPosition)
+        {
+            return SampleHeightDelta(InPosition) - (InPreviousEdits ? InPreviousEdits->SampleHeightDelta(InPosition) : 0.0f);
+        };
+
+    for (int32 X = 0; X <= InOutTile.Resolution; X++)
+    {
+        for (int32 Y = 0; Y <= InOutTile.Resolution; Y++)
+        {
+            int32 VertexIndex = InOutTile.GetVertexIndex(X, Y);
+            FVector2D Position = SectionOrigin + FVector2D(X * Step, Y * Step);
+
+            float HeightDelta = SampleEditDelta(Position);
+            Heights[VertexIndex] = InOutTile.HeightQuantization.Encode(InOutTile.GetHeight(VertexIndex) + HeightDelta);
+            bHeightsChanged |= HeightDelta != 0.0f;
+
+            // Paint tints the generated colors rather than replacing them, Unpainted vertices sample white.
+            if (bPainted)
+            {
+                FLinearColor PaintColor(SamplePaint(Position));
+                if (!InOutTile.Colors.IsEmpty())
+                {
+                    PaintColor *= FLinearColor(InOutTile.Colors[VertexIndex]);
+                }
+                OutVertexColors[VertexIndex] = PaintColor.ToFColor(false);
+            }
+        }
+    }
+
+    // Paint alone keeps the heights and normals the section was built with.
+    if (!bHeightsChanged)
+    {
+        return;
+    }
+
+    // The generated normals are kept and tilted by the slope of the edit, Taken from central differences of the delta field.
+    // The deltas are sampled across tile borders through the neighbouring edit tiles, So both sections agree on the normals of a shared edge.
+    for (int32 X = 0; X <= InOutTile.Resolution; X++)
+    {
+        for (int32 Y = 0; Y <= InOutTile.Resolution; Y++)
+        {
+            int32 VertexIndex = InOutTile.GetVertexIndex(X, Y);
+            FVector2D Position = SectionOrigin + FVector2D(X * Step, Y * Step);
+
+            float SlopeX = (SampleEditDelta(Position + FVector2D(Step, 0.0)) - SampleEditDelta(Position - FVector2D(Step, 0.0))) / (2.0f * Step);
+            float SlopeY = (SampleEditDelta(Position + FVector2D(0.0, Step)) - SampleEditDelta(Position - FVector2D(0.0, Step))) / (2.0f * Step);
+            if (SlopeX == 0.0f && SlopeY == 0.0f)
+            {
+                continue;
+            }
+
+            FVector3f Normal = InOutTile.GetNormal(VertexIndex);
+            float NormalZ = FMath::Max(Normal.Z, UE_KINDA_SMALL_NUMBER);
+            FVector3f EditedNormal(Normal.X / NormalZ - SlopeX, Normal.Y / NormalZ - SlopeY, 1.0f);
+            InOutTile.Normals[VertexIndex] = FLandscapeHeightfieldTile::EncodeNormal(EditedNormal.GetSafeNormal());
+        }
+    }
+    InOutTile.Heights = MoveTemp(Heights);
+}
+
+// Edit Layer
+
+void FLandscapeEditLayer::Reset(float InSectionScale, int32 InResolution)
+{
+    Tiles.Empty();
+    SectionScale = InSectionScale;
+    Resolution = FMath::Max(InResolution, 1);
+}
+
+FLandscapeEditTilePtr FLandscapeEditLayer::FindTile(const FIntPoint& InChunk) const
+{
+    const FLandscapeEditTilePtr* Tile = Tiles.Find(InChunk);
+    return Tile ? *Tile : nullptr;
+}
+
+FLandscapeEditSnapshot FLandscapeEditLayer::GetSnapshot(const FIntPoint& InChunk) const
+{
+    FLandscapeEditSnapshot Snapshot;
+    Snapshot.Chunk = InChunk;
+    Snapshot.SectionScale = SectionScale;
+    Snapshot.Resolution = Resolution;
+
+    if (!Tiles.IsEmpty())
+    {
+        for (int32 SlotX = 0; SlotX < 3; SlotX++)
+        {
+            for (int32 SlotY = 0; SlotY < 3; SlotY++)
+            {
+                Snapshot.Tiles[SlotX * 3 + SlotY] = FindTile(InChunk + FIntPoint(SlotX - 1, SlotY - 1));
+            }
+        }
+    }
+    return Snapshot;
+}
+
+FBox2D FLandscapeEditLayer::GetStrokeBounds(const FLandscapeBrushStroke& InStroke, const FVector& InLandscapeOrigin) const
+{
+    float Extent = FMath::Max(InStroke.Radius, 1.0f) * (InStroke.Mode == ELandscapeBrushMode::Crater ? LandscapeEditLayer::CraterRimEnd : 1.0f);
+    Extent += SectionScale / FMath::Max(Resolution, 1);
+
+    FVector2D Center(InStroke.Location.X - InLandscapeOrigin.X, InStroke.Location.Y - InLandscapeOrigin.Y);
+    return FBox2D(Center - FVector2D(Extent), Center + FVector2D(Extent));
+}
+
+FBox2D FLandscapeEditLayer::GetTileBounds(const FIntPoint& InChunk) const
+{
+    double CellSize = SectionScale / FMath::Max(Resolution, 1);
+    FVector2D TileMin = FVector2D(InChunk) * SectionScale;
+    return FBox2D(TileMin - FVector2D(CellSize), TileMin + FVector2D(SectionScale + CellSize));
+}
+
+// Visits every tile the stroke reaches, including the tiles that only share a border sample with it,
+// so samples on a shared border are written in both tiles from the same position and stay equal.
+void FLandscapeEditLayer::ApplyBrush(const FLandscapeBrushStroke& InStroke, const FVector& InLandscapeOrigin, const FLandscapeHeightfieldStore* InHeightfieldStore, TArray<FIntPoint>& OutChangedChunks)
+{
+    using namespace LandscapeEditLayer;
+
+    if (SectionScale <= 0.0f || Resolution <= 0)
+    {
+        return;
+    }
+
+    FVector2D Center(InStroke.Location.X - InLandscapeOrigin.X, InStroke.Location.Y - InLandscapeOrigin.Y);
+    float Radius = FMath::Max(InStroke.Radius, 1.0f);
+    float Extent = Radius * (InStroke.Mode == ELandscapeBrushMode::Crater ? CraterRimEnd : 1.0f);
+    float Alpha = FMath::Clamp(InStroke.Strength, 0.0f, 1.0f);
+    double CellSize = double(SectionScale) / Resolution;
+    int32 NumSamples = FMath::Square(Resolution + 1);
+
+    FIntPoint MinChunk(FMath::FloorToInt32((Center.X - Extent) / SectionScale), FMath::FloorToInt32((Center.Y - Extent) / SectionScale));
+    FIntPoint MaxChunk(FMath::FloorToInt32((Center.X + Extent) / SectionScale), FMath::FloorToInt32((Center.Y + Extent) / SectionScale));
+
+    for (int32 ChunkX = MinChunk.X; ChunkX <= MaxChunk.X; ChunkX++)
+    {
+        for (int32 ChunkY = MinChunk.Y; ChunkY <= MaxChunk.Y; ChunkY++)
+        {
+            FIntPoint Chunk(ChunkX, ChunkY);
+            FVector2D TileMin = FVector2D(Chunk) * SectionScale;
+
+            int32 MinX = FMath::Clamp(FMath::CeilToInt32((Center.X - Extent - TileMin.X) / CellSize), 0, Resolution);
+            int32 MaxX = FMath::Clamp(FMath::FloorToInt32((Center.X + Extent - TileMin.X) / CellSize), 0, Resolution);
+            int32 MinY = FMath::Clamp(FMath::CeilToInt32((Center.Y - Extent - TileMin.Y) / CellSize), 0, Resolution);
+            int32 MaxY = FMath::Clamp(FMath::FloorToInt32((Center.Y + Extent - TileMin.Y) / CellSize), 0, Resolution);
+            if (MinX > MaxX || MinY > MaxY)
+            {
+                continue;
+            }
+
+            const FLandscapeEditTilePtr* ExistingTile = Tiles.Find(Chunk);
+            TSharedPtr<FLandscapeEditTile, ESPMode::ThreadSafe> NewTile = ExistingTile ? MakeShared<FLandscapeEditTile, ESPMode::ThreadSafe>(**ExistingTile) : MakeShared<FLandscapeEditTile, ESPMode::ThreadSafe>();
+            if (!ExistingTile)
+            {
+                NewTile->HeightDeltas.SetNumZeroed(NumSamples);
+            }
+            if (InStroke.Mode == ELandscapeBrushMode::Paint && NewTile->Paint.IsEmpty())
+            {
+                NewTile->Paint.Init(FColor::White, NumSamples);
+            }
+
+            bool bChanged = false;
+            for (int32 X = MinX; X <= MaxX; X++)
+            {
+                for (int32 Y = MinY; Y <= MaxY; Y++)
+                {
+                    FVector2D Position = TileMin + FVector2D(X * CellSize, Y * CellSize);
+                    float Distance = float(FVector2D::Distance(Position, Center));
+                    int32 SampleIndex = X * (Resolution + 1) + Y;
+                    float& HeightDelta = NewTile->HeightDeltas[SampleIndex];
+
+                    if (InStroke.Mode == ELandscapeBrushMode::Crater)
+                    {
+                        float CraterDelta = GetCraterProfile(Distance / Radius) * InStroke.Strength;
+                        HeightDelta += CraterDelta;
+                        bChanged |= CraterDelta != 0.0f;
+                        continue;
+                    }
+
+                    float Weight = GetBrushWeight(Distance, Radius, InStroke.Hardness);
+                    if (Weight <= 0.0f)
+                    {
+                        continue;
+                    }
+
+                    switch (InStroke.Mode)
+                    {
+                    case ELandscapeBrushMode::Raise:
+                        HeightDelta += InStroke.Strength * Weight;
+                        break;
+
+                    case ELandscapeBrushMode::Lower:
+                        HeightDelta -= InStroke.Strength * Weight;
+                        break;
+
+                    case ELandscapeBrushMode::Flatten:
+                    {
+                        float SurfaceHeight;
+                        FVector WorldLocation(Position.X + InLandscapeOrigin.X, Position.Y + InLandscapeOrigin.Y, InLandscapeOrigin.Z);
+                        if (!InHeightfieldStore || !InHeightfieldStore->SampleHeight(WorldLocation, SurfaceHeight))
+                        {
+                            continue;
+                        }
+                        HeightDelta += (InStroke.TargetHeight - SurfaceHeight) * Weight * Alpha;
+                        break;
+                    }
+
+                    case ELandscapeBrushMode::Paint:
+                        NewTile->Paint[SampleIndex] = LerpColor(NewTile->Paint[SampleIndex], InStroke.PaintColor, Weight * Alpha);
+                        break;
+
+                    default:
+                        continue;
+                    }
+                    bChanged = true;
+                }
+            }
+
+            if (bChanged)
+            {
+                // The authority keeps the same quantized deltas it replicates and saves, So every machine builds identical sections.
+                NewTile->Quantize();
+                NewTile->Revision = ExistingTile ? (*ExistingTile)->Revision + 1 : 1;
+                Tiles.Add(Chunk, NewTile);
+                OutChangedChunks.Add(Chunk);
+            }
+        }
+    }
+}
+
+FLandscapeEditTilePayload FLandscapeEditLayer::MakePayload(const FIntPoint& InChunk) const
+{
+    FLandscapeEditTilePayload Payload;
+    Payload.Chunk = InChunk;
+
+    if (FLandscapeEditTilePtr Tile = FindTile(InChunk))
+    {
+        TArray<uint8> RawData;
+        FMemoryWriter Writer(RawData);
+        Tile->Write(Writer, Resolution);
+
+        Payload.Revision = Tile->Revision;
+        LandscapeEditLayer::CompressData(RawData, Payload.Data);
+    }
+    return Payload;
+}
+
+bool FLandscapeEditLayer::ApplyPayload(const FLandscapeEditTilePayload& InPayload)
+{
+    FLandscapeEditTilePtr ExistingTile = FindTile(InPayload.Chunk);
+    if (ExistingTile && ExistingTile->Revision == InPayload.Revision)
+    {
+        return false;
+    }
+
+    TArray<uint8> RawData;
+    if (!LandscapeEditLayer::DecompressData(InPayload.Data, RawData))
+    {
+        return false;
+    }
+
+    FMemoryReader Reader(RawData);
+    TSharedPtr<FLandscapeEditTile, ESPMode::ThreadSafe> Tile = MakeShared<FLandscapeEditTile, ESPMode::ThreadSafe>();
+    if (!Tile->Read(Reader, Resolution))
+    {
+        return false;
+    }
+
+    Tile->Revision = InPayload.Revision;
+    Tiles.Add(InPayload.Chunk, Tile);
+    return true;
+}
+
+void FLandscapeEditLayer::Save(TArray<uint8>& OutData) const
+{
+    using namespace LandscapeEditLayer;
+
+    TArray<uint8> RawData;
+    FMemoryWriter Writer(RawData);
+
+    uint32 Magic = FileMagic;
+    uint32 Version = FileVersion;
+    float LayerSectionScale = SectionScale;
+    int32 LayerResolution = Resolution;
+    int32 NumTiles = Tiles.Num();
+    Writer << Magic << Version << LayerSectionScale << LayerResolution << NumTiles;
+
+    for (const TPair<FIntPoint, FLandscapeEditTilePtr>& Tile : Tiles)
+    {
+        FIntPoint Chunk = Tile.Key;
+        Writer << Chunk;
+        Tile.Value->Write(Writer, Resolution);
+    }
+
+    CompressData(RawData, OutData);
+}
+
+bool FLandscapeEditLayer::Load(TConstArrayView<uint8> InData, TArray<FIntPoint>& OutChangedChunks)
+{
+    using namespace LandscapeEditLayer;
+
+    TArray<uint8> RawData;
+    if (!DecompressData(InData, RawData))
+    {
+        return false;
+    }
+
+    FMemoryReader Reader(RawData);
+    uint32 Magic = 0;
+    uint32 Version = 0;
+    float LayerSectionScale = 0.0f;
+    int32 LayerResolution = 0;
+    int32 NumTiles = 0;
+    Reader << Magic << Version << LayerSectionScale << LayerResolution << NumTiles;
+
+    // Edits saved at another section scale or edit resolution do not line up with this landscapes chunks.
+    if (Reader.IsError() || Magic != FileMagic || Version != FileVersion || LayerSectionScale != SectionScale || LayerResolution != Resolution || NumTiles < 0)
+    {
+        return false;
+    }
+
+    TMap<FIntPoint, FLandscapeEditTilePtr> LoadedTiles;
+    for (int32 i = 0; i < NumTiles; i++)
+    {
+        FIntPoint Chunk;
+        Reader << Chunk;
+
+        TSharedPtr<FLandscapeEditTile, ESPMode::ThreadSafe> Tile = MakeShared<FLandscapeEditTile, ESPMode::ThreadSafe>();
+        if (Reader.IsError() || !Tile->Read(Reader, Resolution))
+        {
+            return false;
+        }
+
+        FLandscapeEditTilePtr ExistingTile = FindTile(Chunk);
+        Tile->Revision = FMath::Max(Tile->Revision, ExistingTile ? ExistingTile->Revision + 1 : 1);
+        LoadedTiles.Add(Chunk, Tile);
+    }
+
+    for (const TPair<FIntPoint, FLandscapeEditTilePtr>& ExistingTile : Tiles)
+    {
+        if (!LoadedTiles.Contains(ExistingTile.Key))
+        {
+            TSharedPtr<FLandscapeEditTile, ESPMode::ThreadSafe> ClearedTile = MakeShared<FLandscapeEditTile, ESPMode::ThreadSafe>();
+            ClearedTile->HeightDeltas.SetNumZeroed(FMath::Square(Resolution + 1));
+            ClearedTile->Revision = ExistingTile.Value->Revision + 1;
+            LoadedTiles.Add(ExistingTile.Key, ClearedTile);
+        }
+    }
+
+    Tiles = MoveTemp(LoadedTiles);
+    Tiles.GenerateKeyArray(OutChangedChunks);
+    return true;
+}
@@ -0,0 +1,169 @@
+// Copyright 2024 Samuel Freeman All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "LandscapeEditLayer.generated.h"
+
+class FLandscapeHeightfieldStore;
+struct FLandscapeHeightfieldTile;
+
+
+UENUM(BlueprintType)
+enum class ELandscapeBrushMode : uint8
+{
+    // Adds Strength to the surface, Full strength inside the hardness radius then fading out to Radius.
+    Raise,
+
+    // Takes Strength off the surface with the same falloff as Raise.
+    Lower,
+
+    // Pulls the surface towards TargetHeight, A Strength of 1 reaches it inside the hardness radius. Only resident terrain is flattened.
+    Flatten,
+
+    // A bowl Strength deep across Radius with a raised rim just outside it.
+    Crater,
+
+    // Blends the vertex color towards PaintColor by Strength (0 - 1), Heights are left alone.
+    Paint
+};
+
+// One brush application, Locations and heights are in world space.
+USTRUCT(BlueprintType)
+struct FLandscapeBrushStroke
+{
+    GENERATED_BODY()
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Brush")
+    ELandscapeBrushMode Mode = ELandscapeBrushMode::Raise;
+
+    // Only X and Y are used.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Brush")
+    FVector Location = FVector::ZeroVector;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Brush", meta = (ClampMin = "1.0"))
+    float Radius = 500.0f;
+
+    // Fraction of the radius at full strength, The rest fades out smoothly.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Brush", meta = (ClampMin = "0.0", ClampMax = "1.0"))
+    float Hardness = 0.5f;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Brush")
+    float Strength = 100.0f;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Brush")
+    float TargetHeight = 0.0f;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Brush")
+    FColor PaintColor = FColor::White;
+};
+
+// One edit tile as it is replicated, Data is the compressed tile, Revision lets clients skip tiles they already have.
+USTRUCT()
+struct FLandscapeEditTilePayload
+{
+    GENERATED_BODY()
+
+    UPROPERTY()
+    FIntPoint Chunk = FIntPoint::ZeroValue;
+
+    UPROPERTY()
+    uint32 Revision = 0;
+
+    UPROPERTY()
+    TArray<uint8> Data;
+};
+
+// Height deltas and paint of one chunk on a grid of Resolution cells covering [Chunk * SectionScale, (Chunk + 1) * SectionScale] relative to the landscape,
+// laid out X major like FLandscapeHeightfieldTile. Border samples are shared with the neighbouring tile and always hold the same value in both.
+// Independent of the section grid, so every Lod depth samples the same edits.
+struct FLandscapeEditTile
+{
+    uint32 Revision = 0;
+    TArray<float> HeightDeltas;
+
+    // Empty until the tile is painted, White wherever it was not.
+    TArray<FColor> Paint;
+
+    // Snaps HeightDeltas to the fixed delta step every tile of the layer shares, Called on the authority before a tile is published
+    // so it holds exactly what clients and save games decode. A shared border sample snaps to the same value in both tiles,
+    // And snapping an already snapped delta leaves it unchanged.
+    void Quantize();
+
+    // Deltas are written as whole delta steps, Paint is stored as is.
+    void Write(FArchive& Ar, int32 InResolution) const;
+    bool Read(FArchive& Ar, int32 InResolution);
+};
+
+typedef TSharedPtr<const FLandscapeEditTile, ESPMode::ThreadSafe> FLandscapeEditTilePtr;
+
+// The edit tiles a section can touch, Captured on the game thread when a job is issued so the worker never reads the layer.
+// Sections are offset from their chunk by the grid origin, so the tiles of the chunk and all eight neighbours are kept.
+struct FLandscapeEditSnapshot
+{
+    FIntPoint Chunk = FIntPoint::ZeroValue;
+    float SectionScale = 0.0f;
+    int32 Resolution = 0;
+    FLandscapeEditTilePtr Tiles[9];
+
+    bool IsEmpty() const;
+    bool HasPaint() const;
+
+    // InPosition is relative to the landscape, Bilinear over the edit grid.
+    float SampleHeightDelta(const FVector2D& InPosition) const;
+    FColor SamplePaint(const FVector2D& InPosition) const;
+
+    // Adds the edits to a section tile of Chunk, Minus InPreviousEdits when the tile already has those applied.
+    // The tiles normals are tilted by the edit slope rather than derived again, OutVertexColors is the paint over the tiles Colors
+    // and is left empty while no tile around the section was painted.
+    void ApplyToTile(FLandscapeHeightfieldTile& InOutTile, const FLandscapeEditSnapshot* InPreviousEdits, TArray<FColor>& OutVertexColors) const;
+
+private:
+
+    const FLandscapeEditTile* FindTile(const FVector2D& InPosition, FVector2D& OutGridPosition) const;
+};
+
+// Sparse edits on top of the generated terrain (digging, foundations, craters, paint), One tile per chunk that was ever edited.
+// Tiles are immutable once added, An edit swaps in a changed copy so section jobs keep the snapshot they were issued with.
+// Only used on the game thread.
+class FLandscapeEditLayer
+{
+public:
+
+    // Drops every edit, Called when the section scale or edit resolution no longer matches.
+    void Reset(float InSectionScale, int32 InResolution);
+
+    bool IsEmpty() const { return Tiles.IsEmpty(); }
+    int32 Num() const { return Tiles.Num(); }
+    float GetSectionScale() const { return SectionScale; }
+    int32 GetResolution() const { return Resolution; }
+
+    FLandscapeEditTilePtr FindTile(const FIntPoint& InChunk) const;
+    FLandscapeEditSnapshot GetSnapshot(const FIntPoint& InChunk) const;
+    void GetChunks(TArray<FIntPoint>& OutChunks) const { Tiles.GenerateKeyArray(OutChunks); }
+
+    // Area relative to the landscape whose sections change with the stroke or tile, Padded by one edit cell for the normals along it.
+    FBox2D GetStrokeBounds(const FLandscapeBrushStroke& InStroke, const FVector& InLandscapeOrigin) const;
+    FBox2D GetTileBounds(const FIntPoint& InChunk) const;
+
+    // InHeightfieldStore gives the current surface for Flatten, The chunks whose tiles changed are added to OutChangedChunks.
+    void ApplyBrush(const FLandscapeBrushStroke& InStroke, const FVector& InLandscapeOrigin, const FLandscapeHeightfieldStore* InHeightfieldStore, TArray<FIntPoint>& OutChangedChunks);
+
+    FLandscapeEditTilePayload MakePayload(const FIntPoint& InChunk) const;
+
+    // Returns false when the payload is corrupt or its revision is already applied.
+    bool ApplyPayload(const FLandscapeEditTilePayload& InPayload);
+
+    // The whole layer compressed, for save games.
+    void Save(TArray<uint8>& OutData) const;
+
+    // Replaces every tile, Tiles the save does not have are kept as cleared tiles so replicated clients clear them as well.
+    // Every tile is given a newer revision than the one it replaces, The chunks of all of them are added to OutChangedChunks.
+    bool Load(TConstArrayView<uint8> InData, TArray<FIntPoint>& OutChangedChunks);
+
+private:
+
+    TMap<FIntPoint, FLandscapeEditTilePtr> Tiles;
+    float SectionScale = 0.0f;
+    int32 Resolution = 0;
+};
@@ -0,0 +1,127 @@
+// Copyright 2024 Samuel Freeman All rights reserved.
+
+
+#include "Framework/LandscapeFoliagePlacement.h"
+#include "Framework/LandscapeHeightfield.h"
+#include "Framework/LandscapeBiomePointCache.h"
+#include "Framework/LandscapeStreamingStats.h"
+#include "Math/RandomStream.h"
+
+
+void FLandscapeFoliagePlacement::PlaceSectionInstances(const FLandscapeHeightfieldTile& InTile, const FIntPoint& InChunk, const FVector2D& InNoiseOffset, TConstArrayView<FLandscapeFoliageLayer> InLayers,
+    FLandscapeBiomePointCache* InBiomePointCache, uint32 InRequestId, int32 InBatchSize, TArray<FLandscapeFoliageBatch>& OutBatches)
+{
+    if (!InTile.IsValid())
+    {
+        return;
+    }
+
+    // Biome weights on the tiles own grid, Only computed when a layer filters on biome.
+    TArray<float> BiomeWeights;
+    int32 NumBiomes = 0;
+    if (InBiomePointCache && InLayers.ContainsByPredicate([](const FLandscapeFoliageLayer& Layer) { return Layer.BiomeIndex >= 0; }))
+    {
+        FVector2D GridOrigin = InNoiseOffset + FVector2D(InTile.Origin);
+        InBiomePointCache->ComputeTileWeights(GridOrigin, InTile.GetStep(), InTile.GetVerticesPerSide(), InTile.GetVerticesPerSide(), BiomeWeights);
+        NumBiomes = InBiomePointCache->GetNumBiomes();
+    }
+
+    PlaceSectionInstances(InTile, InChunk, InLayers, BiomeWeights, NumBiomes, GetChunkFoliageSeed(InChunk), InRequestId, InBatchSize, OutBatches);
+}
+
+void FLandscapeFoliagePlacement::PlaceSectionInstances(const FLandscapeHeightfieldTile& InTile, const FIntPoint& InChunk, TConstArrayView<FLandscapeFoliageLayer> InLayers,
+    TConstArrayView<float> InBiomeWeights, int32 InNumBiomes, uint32 InFoliageSeed, uint32 InRequestId, int32 InBatchSize, TArray<FLandscapeFoliageBatch>& OutBatches)
+{
+    LANDSCAPE_SCOPE(STAT_LandscapeFoliagePlacement);
+
+    if (!InTile.IsValid())
+    {
+        return;
+    }
+
+    // Candidates use the closest grid vertex of the weights.
+    int32 GridWidth = InTile.GetVerticesPerSide();
+    bool bHasBiomeWeights = InNumBiomes > 0 && InBiomeWeights.Num() == InNumBiomes * GridWidth * GridWidth;
+
+    int32 BatchSize = FMath::Max(InBatchSize, 1);
+    float Step = InTile.GetStep();
+
+    for (int32 LayerIndex = 0; LayerIndex < InLayers.Num(); LayerIndex++)
+    {
+        const FLandscapeFoliageLayer& Layer = InLayers[LayerIndex];
+        if (!Layer.Mesh || Layer.Spacing <= 0.0f)
+        {
+            continue;
+        }
+        if (Layer.BiomeIndex >= 0 && (!bHasBiomeWeights || Layer.BiomeIndex >= InNumBiomes))
+        {
+            continue;
+        }
+
+        FRandomStream RandomStream(int32(HashCombine(InFoliageSeed, GetTypeHash(LayerIndex))));
+        float MinNormalZ = FMath::Cos(FMath::DegreesToRadians(Layer.MaxSlopeDegrees));
+        int32 CellsPerSide = FMath::Max(FMath::FloorToInt32(InTile.Size / Layer.Spacing), 1);
+        float CellSize = InTile.Size / CellsPerSide;
+
+        FLandscapeFoliageBatch* Batch = nullptr;
+        for (int32 CellX = 0; CellX < CellsPerSide; CellX++)
+        {
+            for (int32 CellY = 0; CellY < CellsPerSide; CellY++)
+            {
+                // Every random number is drawn up front so a rejected candidate does not shift the ones after it.
+                FVector2f Jitter(RandomStream.FRand(), RandomStream.FRand());
+                float Yaw = RandomStream.FRandRange(0.0f, 360.0f);
+                float Scale = RandomStream.FRandRange(Layer.ScaleRange.X, Layer.ScaleRange.Y);
+
+                FVector2f LocalPosition = InTile.Origin + FVector2f((CellX + Jitter.X) * CellSize, (CellY + Jitter.Y) * CellSize);
+                FVector3f Normal = InTile.SampleNormal(LocalPosition);
+                if (Normal.Z < MinNormalZ)
+                {
+                    continue;
+                }
+
+                if (Layer.BiomeIndex >= 0)
+                {
+                    int32 GridX = FMath::Clamp(FMath::RoundToInt32((LocalPosition.X - InTile.Origin.X) / Step), 0, GridWidth - 1);
+                    int32 GridY = FMath::Clamp(FMath::RoundToInt32((LocalPosition.Y - InTile.Origin.Y) / Step), 0, GridWidth - 1);
+                    float BiomeWeight = InBiomeWeights[Layer.BiomeIndex * GridWidth * GridWidth + GridY * GridWidth + GridX];
+                    if (BiomeWeight < Layer.MinBiomeWeight)
+                    {
+                        continue;
+                    }
+                }
+
+                FQuat Rotation = FQuat(FVector::UpVector, FMath::DegreesToRadians(Yaw));
+                if (Layer.bAlignToNormal)
+                {
+                    Rotation = FQuat::FindBetweenNormals(FVector::UpVector, FVector(Normal)) * Rotation;
+                }
+
+                if (!Batch || Batch->Transforms.Num() >= BatchSize)
+                {
+                    Batch = &OutBatches.AddDefaulted_GetRef();
+                    Batch->Chunk = InChunk;
+                    Batch->LayerIndex = LayerIndex;
+                    Batch->RequestId = InRequestId;
+                    Batch->Transforms.Reserve(BatchSize);
+                }
+                Batch->Transforms.Emplace(Rotation, FVector(LocalPosition.X, LocalPosition.Y, InTile.SampleHeight(LocalPosition)), FVector(Scale));
+            }
+        }
+    }
+}
+
+void FLandscapeFoliagePlacement::ProjectToSurface(const FLandscapeHeightfieldTile& InTile, TArrayView<FTransform> InOutTransforms)
+{
+    if (!InTile.IsValid())
+    {
+        return;
+    }
+
+    for (FTransform& Transform : InOutTransforms)
+    {
+        FVector Location = Transform.GetLocation();
+        Location.Z = InTile.SampleHeight(FVector2f(float(Location.X), float(Location.Y)));
+        Transform.SetLocation(Location);
+    }
+}
@@ -0,0 +1,85 @@
+// Copyright 2024 Samuel Freeman All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "LandscapeFoliagePlacement.generated.h"
+
+class UStaticMesh;
+class FLandscapeBiomePointCache;
+struct FLandscapeHeightfieldTile;
+
+
+// One kind of instanced foliage placed straight from the section heightfields.
+USTRUCT(BlueprintType)
+struct FLandscapeFoliageLayer
+{
+    GENERATED_BODY()
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Foliage")
+    TObjectPtr<UStaticMesh> Mesh = nullptr;
+
+    // Average distance between instances, One jittered candidate is placed per Spacing x Spacing cell.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Foliage", meta = (ClampMin = "10.0"))
+    float Spacing = 400.0f;
+
+    // Biome the layer grows in, -1 for every biome.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Foliage")
+    int32 BiomeIndex = -1;
+
+    // Blend weight of BiomeIndex a candidate needs, Lower values let the layer spill into the blend between biomes.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Foliage", meta = (ClampMin = "0.0", ClampMax = "1.0"))
+    float MinBiomeWeight = 0.5f;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Foliage", meta = (ClampMin = "0.0", ClampMax = "90.0"))
+    float MaxSlopeDegrees = 35.0f;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Foliage")
+    FVector2D ScaleRange = FVector2D(0.8f, 1.2f);
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Foliage")
+    bool bAlignToNormal = false;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Foliage")
+    bool bEnableCollision = false;
+
+    // 0 draws the instances at any distance.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Foliage", meta = (ClampMin = "0"))
+    int32 CullDistance = 0;
+};
+
+// Instance transforms for one layer of one section, relative to the section component.
+struct FLandscapeFoliageBatch
+{
+    FIntPoint Chunk = FIntPoint::ZeroValue;
+    int32 LayerIndex = 0;
+
+    // Matches the request on the chunk record, Batches from an older request are dropped.
+    uint32 RequestId = 0;
+
+    TArray<FTransform> Transforms;
+};
+
+// Places foliage on a section from its heightfield and the biome blend weights, No mesh is read back or converted.
+// Placement is deterministic per chunk and layer, so a section streamed back in gets the same instances.
+// Safe to run on any thread.
+class FLandscapeFoliagePlacement
+{
+public:
+
+    // InNoiseOffset is where the section component sits in the space the biomes are generated in,
+    // Instances of each layer are split into batches of at most InBatchSize.
+    static void PlaceSectionInstances(const FLandscapeHeightfieldTile& InTile, const FIntPoint& InChunk, const FVector2D& InNoiseOffset, TConstArrayView<FLandscapeFoliageLayer> InLayers,
+        FLandscapeBiomePointCache* InBiomePointCache, uint32 InRequestId, int32 InBatchSize, TArray<FLandscapeFoliageBatch>& OutBatches);
+
+    // Same placement from biome weights already computed on the tiles grid (planar, InNumBiomes planes) and a stored seed, Used for baked tiles.
+    static void PlaceSectionInstances(const FLandscapeHeightfieldTile& InTile, const FIntPoint& InChunk, TConstArrayView<FLandscapeFoliageLayer> InLayers,
+        TConstArrayView<float> InBiomeWeights, int32 InNumBiomes, uint32 InFoliageSeed, uint32 InRequestId, int32 InBatchSize, TArray<FLandscapeFoliageBatch>& OutBatches);
+
+    // Moves instances placed on an older build of the section onto InTile, Only the height changes.
+    // Used when a Lod update or edit rebuilds a section whose foliage is already placed or still being placed.
+    static void ProjectToSurface(const FLandscapeHeightfieldTile& InTile, TArrayView<FTransform> InOutTransforms);
+
+    // Seed the instances of a chunk are placed from, Each layer draws from its own stream derived from it.
+    static uint32 GetChunkFoliageSeed(const FIntPoint& InChunk) { return HashCombine(GetTypeHash(InChunk.X), GetTypeHash(InChunk.Y)); }
+};
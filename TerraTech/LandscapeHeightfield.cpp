@@ -0,0 +1,332 @@
+// Copyright 2024 Samuel Freeman All rights reserved.
+
+
+#include "Framework/LandscapeHeightfield.h"
+#include "Framework/LandscapeSectionTopology.h"
+#include "Framework/LandscapeStreamingStats.h"
+#include "Mesh/RealtimeMeshBuilder.h"
+
+
+bool FLandscapeHeightfieldTile::ReadFromStreams(const FRealtimeMeshStreamSet& InStreams, int32 InResolution, const FLandscapeHeightQuantization& InHeightQuantization,
+    const FLandscapeSectionTopology* InTopology)
+{
+    LANDSCAPE_SCOPE(STAT_LandscapeSectionReadback);
+    const FRealtimeMeshStream* PositionStream = InStreams.Find(FRealtimeMeshStreams::Position);
+    if (!PositionStream || InResolution < 1)
+    {
+        return false;
+    }
+
+    TRealtimeMeshStreamBuilder<const FVector3f> PositionBuilder(*PositionStream);
+    int32 NumVertices = FMath::Square(InResolution + 1);
+    if (PositionBuilder.Num() != NumVertices)
+    {
+        return false;
+    }
+
+    FBox2f Bounds(ForceInit);
+    for (int32 Index = 0; Index < PositionBuilder.Num(); ++Index)
+    {
+        FVector3f Position = PositionBuilder.Get(Index);
+        Bounds += FVector2f(Position.X, Position.Y);
+    }
+
+    Resolution = InResolution;
+    Size = Bounds.Max.X - Bounds.Min.X;
+    Origin = Bounds.Min;
+    HeightQuantization = InHeightQuantization;
+
+    // The other streams are read through converting builders, Their precision depends on who built the section.
+    const FRealtimeMeshStream* TangentStream = InStreams.Find(FRealtimeMeshStreams::Tangents);
+    const FRealtimeMeshStream* ColorStream = InStreams.Find(FRealtimeMeshStreams::Color);
+    const FRealtimeMeshStream* TexCoordStream = InStreams.Find(FRealtimeMeshStreams::TexCoords);
+    TOptional<TRealtimeMeshStreamBuilder<const TRealtimeMeshTangents<FVector4f>, void>> TangentBuilder;
+    TOptional<TRealtimeMeshStreamBuilder<const FColor, void>> ColorBuilder;
+    TOptional<TRealtimeMeshStridedStreamBuilder<const FVector2f, void>> TexCoordBuilder;
+    if (TangentStream && TangentStream->Num() == NumVertices)
+    {
+        TangentBuilder.Emplace(*TangentStream);
+    }
+    if (ColorStream && ColorStream->Num() == NumVertices)
+    {
+        ColorBuilder.Emplace(*ColorStream);
+    }
+    if (TexCoordStream && TexCoordStream->Num() == NumVertices)
+    {
+        TexCoordBuilder.Emplace(*TexCoordStream, 0);
+    }
+
+    TArray<float> GridHeights;
+    GridHeights.SetNumZeroed(NumVertices);
+    Normals.SetNumZeroed(TangentBuilder.IsSet() ? NumVertices : 0);
+    Colors.Init(FColor::White, ColorBuilder.IsSet() ? NumVertices : 0);
+    UVs.SetNumZeroed(TexCoordBuilder.IsSet() ? NumVertices : 0);
+
+    bool bHasColors = false;
+    bool bHasUVs = false;
+    float Step = GetStep();
+    for (int32 Index = 0; Index < PositionBuilder.Num(); ++Index)
+    {
+        FVector3f Position = PositionBuilder.Get(Index);
+        int32 GridX = FMath::Clamp(FMath::RoundToInt32((Position.X - Origin.X) / Step), 0, Resolution);
+        int32 GridY = FMath::Clamp(FMath::RoundToInt32((Position.Y - Origin.Y) / Step), 0, Resolution);
+        int32 VertexIndex = GetVertexIndex(GridX, GridY);
+        GridHeights[VertexIndex] = Position.Z;
+
+        if (TangentBuilder.IsSet())
+        {
+            Normals[VertexIndex] = EncodeNormal(TangentBuilder->Get(Index).GetNormal());
+        }
+        if (ColorBuilder.IsSet())
+        {
+            Colors[VertexIndex] = ColorBuilder->Get(Index);
+            bHasColors |= Colors[VertexIndex] != FColor::White;
+        }
+        if (TexCoordBuilder.IsSet())
+        {
+            UVs[VertexIndex] = TexCoordBuilder->Get(Index);
+            bHasUVs |= !InTopology || InTopology->LODResolution != Resolution || UVs[VertexIndex] != InTopology->UVs[VertexIndex];
+        }
+    }
+
+    if (!bHasColors)
+    {
+        Colors.Empty();
+    }
+    if (!bHasUVs)
+    {
+        UVs.Empty();
+    }
+
+    if (TangentBuilder.IsSet())
+    {
+        Heights.SetNumUninitialized(NumVertices);
+        for (int32 VertexIndex = 0; VertexIndex < NumVertices; VertexIndex++)
+        {
+            Heights[VertexIndex] = HeightQuantization.Encode(GridHeights[VertexIndex]);
+        }
+    }
+    else
+    {
+        SetHeights(GridHeights);
+    }
+    return true;
+}
+
+void FLandscapeHeightfieldTile::SetHeights(TConstArrayView<float> InHeights)
+{
+    check(InHeights.Num() == FMath::Square(Resolution + 1));
+
+    Heights.SetNumUninitialized(InHeights.Num());
+    for (int32 VertexIndex = 0; VertexIndex < InHeights.Num(); VertexIndex++)
+    {
+        Heights[VertexIndex] = HeightQuantization.Encode(InHeights[VertexIndex]);
+    }
+
+    // Central difference normals, One sided along the section borders.
+    LANDSCAPE_SCOPE(STAT_LandscapeNormals);
+    Normals.SetNumUninitialized(InHeights.Num());
+    float Step = GetStep();
+    for (int32 X = 0; X <= Resolution; X++)
+    {
+        for (int32 Y = 0; Y <= Resolution; Y++)
+        {
+            int32 Left = FMath::Max(X - 1, 0);
+            int32 Right = FMath::Min(X + 1, Resolution);
+            int32 Down = FMath::Max(Y - 1, 0);
+            int32 Up = FMath::Min(Y + 1, Resolution);
+
+            float SlopeX = (InHeights[GetVertexIndex(Right, Y)] - InHeights[GetVertexIndex(Left, Y)]) / ((Right - Left) * Step);
+            float SlopeY = (InHeights[GetVertexIndex(X, Up)] - InHeights[GetVertexIndex(X, Down)]) / ((Up - Down) * Step);
+
+            Normals[GetVertexIndex(X, Y)] = EncodeNormal(FVector3f(-SlopeX, -SlopeY, 1.0f).GetSafeNormal());
+        }
+    }
+}
+
+// Octahedral encoding, The unit sphere is projected onto the octahedron |X| + |Y| + |Z| = 1 and the lower half folded over the upper,
+// X in the low 16 bits and Y in the high 16 bits, both snorm.
+uint32 FLandscapeHeightfieldTile::EncodeNormal(const FVector3f& InNormal)
+{
+    float InvLength = 1.0f / FMath::Max(FMath::Abs(InNormal.X) + FMath::Abs(InNormal.Y) + FMath::Abs(InNormal.Z), UE_SMALL_NUMBER);
+    float OctX = InNormal.X * InvLength;
+    float OctY = InNormal.Y * InvLength;
+    if (InNormal.Z < 0.0f)
+    {
+        float FoldedX = (1.0f - FMath::Abs(OctY)) * (OctX >= 0.0f ? 1.0f : -1.0f);
+        float FoldedY = (1.0f - FMath::Abs(OctX)) * (OctY >= 0.0f ? 1.0f : -1.0f);
+        OctX = FoldedX;
+        OctY = FoldedY;
+    }
+
+    uint32 EncodedX = uint16(int16(FMath::Clamp(FMath::RoundToInt32(OctX * 32767.0f), -32767, 32767)));
+    uint32 EncodedY = uint16(int16(FMath::Clamp(FMath::RoundToInt32(OctY * 32767.0f), -32767, 32767)));
+    return EncodedX | (EncodedY << 16);
+}
+
+FVector3f FLandscapeHeightfieldTile::DecodeNormal(uint32 InEncodedNormal)
+{
+    float OctX = float(int16(uint16(InEncodedNormal & 0xFFFF))) / 32767.0f;
+    float OctY = float(int16(uint16(InEncodedNormal >> 16))) / 32767.0f;
+
+    FVector3f Normal(OctX, OctY, 1.0f - FMath::Abs(OctX) - FMath::Abs(OctY));
+    float Fold = FMath::Max(-Normal.Z, 0.0f);
+    Normal.X += Normal.X >= 0.0f ? -Fold : Fold;
+    Normal.Y += Normal.Y >= 0.0f ? -Fold : Fold;
+    return Normal.GetSafeNormal(UE_SMALL_NUMBER, FVector3f::UpVector);
+}
+
+int64 FLandscapeHeightfieldTile::GetPayloadSize(int32 InResolution, bool bInHasColors, bool bInHasUVs)
+{
+    int64 NumVertices = FMath::Square(int64(InResolution) + 1);
+    return NumVertices * (sizeof(uint16) + sizeof(uint32) + (bInHasColors ? sizeof(FColor) : 0) + (bInHasUVs ? sizeof(FVector2f) : 0));
+}
+
+void FLandscapeHeightfieldTile::WritePayload(uint8* OutData) const
+{
+    FMemory::Memcpy(OutData, Heights.GetData(), Heights.Num() * sizeof(uint16));
+    OutData += Heights.Num() * sizeof(uint16);
+    FMemory::Memcpy(OutData, Normals.GetData(), Normals.Num() * sizeof(uint32));
+    OutData += Normals.Num() * sizeof(uint32);
+    FMemory::Memcpy(OutData, Colors.GetData(), Colors.Num() * sizeof(FColor));
+    OutData += Colors.Num() * sizeof(FColor);
+    FMemory::Memcpy(OutData, UVs.GetData(), UVs.Num() * sizeof(FVector2f));
+}
+
+void FLandscapeHeightfieldTile::ReadPayload(const uint8* InData, bool bInHasColors, bool bInHasUVs)
+{
+    int32 NumVertices = FMath::Square(Resolution + 1);
+    Heights.SetNumUninitialized(NumVertices);
+    Normals.SetNumUninitialized(NumVertices);
+    Colors.SetNumUninitialized(bInHasColors ? NumVertices : 0);
+    UVs.SetNumUninitialized(bInHasUVs ? NumVertices : 0);
+
+    FMemory::Memcpy(Heights.GetData(), InData, Heights.Num() * sizeof(uint16));
+    InData += Heights.Num() * sizeof(uint16);
+    FMemory::Memcpy(Normals.GetData(), InData, Normals.Num() * sizeof(uint32));
+    InData += Normals.Num() * sizeof(uint32);
+    FMemory::Memcpy(Colors.GetData(), InData, Colors.Num() * sizeof(FColor));
+    InData += Colors.Num() * sizeof(FColor);
+    FMemory::Memcpy(UVs.GetData(), InData, UVs.Num() * sizeof(FVector2f));
+}
+
+// Splits the point into its grid cell and the position inside the cell, both clamped to the tile.
+static void LocateCell(const FLandscapeHeightfieldTile& InTile, const FVector2f& InLocalPosition, int32& OutCellX, int32& OutCellY, float& OutFracX, float& OutFracY)
+{
+    float Step = InTile.GetStep();
+    float GridX = FMath::Clamp((InLocalPosition.X - InTile.Origin.X) / Step, 0.0f, float(InTile.Resolution));
+    float GridY = FMath::Clamp((InLocalPosition.Y - InTile.Origin.Y) / Step, 0.0f, float(InTile.Resolution));
+
+    OutCellX = FMath::Min(FMath::FloorToInt32(GridX), InTile.Resolution - 1);
+    OutCellY = FMath::Min(FMath::FloorToInt32(GridY), InTile.Resolution - 1);
+    OutFracX = GridX - OutCellX;
+    OutFracY = GridY - OutCellY;
+}
+
+// Each cell is split along the (X + 1, Y) to (X, Y + 1) diagonal, See FLandscapeSectionTopology.
+float FLandscapeHeightfieldTile::SampleHeight(const FVector2f& InLocalPosition) const
+{
+    int32 CellX, CellY;
+    float FracX, FracY;
+    LocateCell(*this, InLocalPosition, CellX, CellY, FracX, FracY);
+
+    float Height00 = GetHeight(GetVertexIndex(CellX, CellY));
+    float Height10 = GetHeight(GetVertexIndex(CellX + 1, CellY));
+    float Height01 = GetHeight(GetVertexIndex(CellX, CellY + 1));
+
+    if (FracX + FracY <= 1.0f)
+    {
+        return Height00 + FracX * (Height10 - Height00) + FracY * (Height01 - Height00);
+    }
+
+    float Height11 = GetHeight(GetVertexIndex(CellX + 1, CellY + 1));
+    return Height11 + (1.0f - FracX) * (Height01 - Height11) + (1.0f - FracY) * (Height10 - Height11);
+}
+
+FVector3f FLandscapeHeightfieldTile::SampleNormal(const FVector2f& InLocalPosition) const
+{
+    int32 CellX, CellY;
+    float FracX, FracY;
+    LocateCell(*this, InLocalPosition, CellX, CellY, FracX, FracY);
+
+    FVector3f Bottom = FMath::Lerp(GetNormal(GetVertexIndex(CellX, CellY)), GetNormal(GetVertexIndex(CellX + 1, CellY)), FracX);
+    FVector3f Top = FMath::Lerp(GetNormal(GetVertexIndex(CellX, CellY + 1)), GetNormal(GetVertexIndex(CellX + 1, CellY + 1)), FracX);
+    return FMath::Lerp(Bottom, Top, FracY).GetSafeNormal(UE_SMALL_NUMBER, FVector3f::UpVector);
+}
+
+void FLandscapeHeightfieldTile::ResampleFrom(const FLandscapeHeightfieldTile& InSource, int32 InResolution)
+{
+    Resolution = InResolution;
+    Size = InSource.Size;
+    Origin = InSource.Origin;
+    HeightQuantization = InSource.HeightQuantization;
+    Colors.Empty();
+    UVs.Empty();
+
+    TArray<float> GridHeights;
+    GridHeights.SetNumUninitialized(FMath::Square(Resolution + 1));
+
+    float Step = GetStep();
+    for (int32 X = 0; X <= Resolution; X++)
+    {
+        for (int32 Y = 0; Y <= Resolution; Y++)
+        {
+            GridHeights[GetVertexIndex(X, Y)] = InSource.SampleHeight(Origin + FVector2f(X * Step, Y * Step));
+        }
+    }
+    SetHeights(GridHeights);
+}
+
+void FLandscapeHeightfieldTile::BuildStreamSet(const FLandscapeSectionTopology& InTopology, FRealtimeMeshStreamSet& OutStreams, TConstArrayView<FColor> InVertexColors) const
+{
+    LANDSCAPE_SCOPE(STAT_LandscapeStreamBuild);
+    check(InTopology.LODResolution == Resolution);
+    check(InVertexColors.IsEmpty() || InVertexColors.Num() == Heights.Num());
+    TConstArrayView<FColor> VertexColors = InVertexColors.IsEmpty() ? TConstArrayView<FColor>(Colors) : InVertexColors;
+    TConstArrayView<FVector2f> VertexUVs = UVs.IsEmpty() ? TConstArrayView<FVector2f>(InTopology.UVs) : TConstArrayView<FVector2f>(UVs);
+
+    TRealtimeMeshBuilderLocal<uint32, FPackedNormal, FVector2DHalf, 1> Builder(OutStreams);
+    Builder.EnableTangents();
+    Builder.EnableTexCoords();
+    Builder.EnableColors();
+    Builder.EnablePolyGroups();
+
+    float Step = GetStep();
+    for (int32 X = 0; X <= Resolution; X++)
+    {
+        for (int32 Y = 0; Y <= Resolution; Y++)
+        {
+            int32 VertexIndex = GetVertexIndex(X, Y);
+            FVector3f Position(Origin.X + X * Step, Origin.Y + Y * Step, GetHeight(VertexIndex));
+
+            Builder.AddVertex(Position)
+                .SetNormalAndTangent(GetNormal(VertexIndex), InTopology.Tangents[VertexIndex])
+                .SetColor(VertexColors.IsEmpty() ? FColor::White : VertexColors[VertexIndex])
+                .SetTexCoord(VertexUVs[VertexIndex]);
+        }
+    }
+
+    for (int32 TriangleIndex = 0; TriangleIndex + 2 < InTopology.Triangles.Num(); TriangleIndex += 3)
+    {
+        Builder.AddTriangle(InTopology.Triangles[TriangleIndex], InTopology.Triangles[TriangleIndex + 1], InTopology.Triangles[TriangleIndex + 2], 0);
+    }
+}
+
+void FLandscapeHeightfieldTile::ApplyToRealtimeMesh(URealtimeMeshSimple* InRealtimeMesh, const FRealtimeMeshSectionGroupKey& InGroupKey, const FLandscapeSectionTopology& InTopology, bool bGroupExists,
+    const FRealtimeMeshSectionConfig& InSectionConfig, bool bCreateCollision, TConstArrayView<FColor> InVertexColors) const
+{
+    FRealtimeMeshStreamSet StreamSet;
+    BuildStreamSet(InTopology, StreamSet, InVertexColors);
+
+    if (bGroupExists)
+    {
+        InRealtimeMesh->UpdateSectionGroup(InGroupKey, MoveTemp(StreamSet));
+    }
+    else
+    {
+        InRealtimeMesh->CreateSectionGroup(InGroupKey, MoveTemp(StreamSet));
+    }
+
+    FRealtimeMeshSectionKey SectionKey = FRealtimeMeshSectionKey::CreateForPolyGroup(InGroupKey, 0);
+    InRealtimeMesh->UpdateSectionConfig(SectionKey, InSectionConfig, bCreateCollision);
+}
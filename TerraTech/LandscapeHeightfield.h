@@ -0,0 +1,104 @@
+// Copyright 2024 Samuel Freeman All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "RealtimeMeshSimple.h"
+
+struct FLandscapeSectionTopology;
+
+// Fixed height grid shared by every tile of a landscape, A stored height H decodes to Origin + H * Step.
+// Both come from the landscape params (and so its chunk cache signature), never from a tiles own range,
+// So a height shared by two tiles encodes to the same value in both and decodes bit identically.
+struct FLandscapeHeightQuantization
+{
+    float Origin = -32768.0f;
+    float Step = 1.0f;
+
+    // Heights outside Origin to Origin + 65535 * Step are clamped.
+    uint16 Encode(float InHeight) const { return uint16(FMath::Clamp(FMath::RoundToInt32((InHeight - Origin) / Step), 0, int32(MAX_uint16))); }
+    float Decode(uint16 InHeight) const { return Origin + float(InHeight) * Step; }
+
+    bool operator==(const FLandscapeHeightQuantization& Other) const { return Origin == Other.Origin && Step == Other.Step; }
+};
+
+// Heights and normals of one section on its regular grid, laid out X major like FLandscapeSectionTopology.
+// Used to read a generated section back, keep it resident for queries, store it, and rebuild the section later without evaluating noise.
+// X and Y are implied by the grid so only the height is stored, 16 bits on the landscapes FLandscapeHeightQuantization grid,
+// So neighbouring tiles agree exactly on their shared border. Normals are octahedral encoded in 16 bits per axis, an error of a few thousandths of a degree.
+// A vertex takes 6 bytes instead of the 24 of a float position and normal. This is the CPU side format only (queries, disk cache, baked archive),
+// Sections are still uploaded with the regular realtime mesh vertex layout.
+struct FLandscapeHeightfieldTile
+{
+    int32 Resolution = 0;
+    float Size = 0.0f;
+
+    // Local position of grid vertex (0, 0) inside the section component.
+    FVector2f Origin = FVector2f::ZeroVector;
+
+    FLandscapeHeightQuantization HeightQuantization;
+
+    TArray<uint16> Heights;
+    TArray<uint32> Normals;
+
+    // Vertex colors and UVs the section was generated with, Empty when every color is white or the UVs are the shared topology UVs.
+    TArray<FColor> Colors;
+    TArray<FVector2f> UVs;
+
+    int32 GetVerticesPerSide() const { return Resolution + 1; }
+    int32 GetVertexIndex(int32 InX, int32 InY) const { return InX * (Resolution + 1) + InY; }
+    float GetStep() const { return Size / FMath::Max(Resolution, 1); }
+    bool IsValid() const
+    {
+        return Resolution > 0 && Heights.Num() == FMath::Square(Resolution + 1) && Normals.Num() == Heights.Num()
+            && (Colors.IsEmpty() || Colors.Num() == Heights.Num()) && (UVs.IsEmpty() || UVs.Num() == Heights.Num());
+    }
+
+    float GetHeight(int32 InVertexIndex) const { return HeightQuantization.Decode(Heights[InVertexIndex]); }
+    FVector3f GetNormal(int32 InVertexIndex) const { return DecodeNormal(Normals[InVertexIndex]); }
+
+    SIZE_T GetAllocatedSize() const { return Heights.GetAllocatedSize() + Normals.GetAllocatedSize() + Colors.GetAllocatedSize() + UVs.GetAllocatedSize(); }
+
+    // Quantizes a full grid of heights, Resolution and HeightQuantization must already be set, Normals are derived from the unquantized heights.
+    // Only used where there are no generated normals to keep (collision grids, sections without a tangent stream), Normals along the border are one sided.
+    void SetHeights(TConstArrayView<float> InHeights);
+
+    // Flat layout shared by the chunk cache and the baked archive, Heights, normals, then colors and UVs when the tile has them.
+    int64 GetPayloadSize() const { return GetPayloadSize(Resolution, !Colors.IsEmpty(), !UVs.IsEmpty()); }
+    static int64 GetPayloadSize(int32 InResolution, bool bInHasColors, bool bInHasUVs);
+    void WritePayload(uint8* OutData) const;
+
+    // Resolution and HeightQuantization must already be set, The payload is copied out so the source can be unmapped straight after.
+    void ReadPayload(const uint8* InData, bool bInHasColors, bool bInHasUVs);
+
+    static uint32 EncodeNormal(const FVector3f& InNormal);
+    static FVector3f DecodeNormal(uint32 InEncodedNormal);
+
+    // Maps every vertex of a built section onto the grid, keeping the normals, colors and UVs it was generated with,
+    // so a section rebuilt from the tile lights and shades exactly like the original, seams along its borders included.
+    // UVs equal to those of InTopology are not kept. Fails if the section is not a plain (Resolution + 1)^2 grid.
+    bool ReadFromStreams(const FRealtimeMeshStreamSet& InStreams, int32 InResolution, const FLandscapeHeightQuantization& InHeightQuantization,
+        const FLandscapeSectionTopology* InTopology = nullptr);
+
+    // Height of the section surface at a point local to the section component, Interpolated over the same two triangles per cell the mesh uses
+    // so it matches the rendered surface and collision exactly. Points outside the tile are clamped to its border.
+    float SampleHeight(const FVector2f& InLocalPosition) const;
+
+    // Vertex normals blended bilinearly across the cell.
+    FVector3f SampleNormal(const FVector2f& InLocalPosition) const;
+
+    bool ContainsLocal(const FVector2f& InLocalPosition) const
+    {
+        return InLocalPosition.X >= Origin.X && InLocalPosition.Y >= Origin.Y && InLocalPosition.X <= Origin.X + Size && InLocalPosition.Y <= Origin.Y + Size;
+    }
+
+    // Fills this tile with InSource sampled on a coarser InResolution grid covering the same area, On the same height grid.
+    void ResampleFrom(const FLandscapeHeightfieldTile& InSource, int32 InResolution);
+
+    // InVertexColors is one color per vertex (terrain paint) and replaces Colors, The tiles own Colors (or white) are used when it is empty.
+    void BuildStreamSet(const FLandscapeSectionTopology& InTopology, FRealtimeMeshStreamSet& OutStreams, TConstArrayView<FColor> InVertexColors = TConstArrayView<FColor>()) const;
+
+    // Builds the stream set and hands it to the realtime mesh, Updating the group if the section already has one.
+    void ApplyToRealtimeMesh(URealtimeMeshSimple* InRealtimeMesh, const FRealtimeMeshSectionGroupKey& InGroupKey, const FLandscapeSectionTopology& InTopology, bool bGroupExists,
+        const FRealtimeMeshSectionConfig& InSectionConfig, bool bCreateCollision, TConstArrayView<FColor> InVertexColors = TConstArrayView<FColor>()) const;
+};
@@ -0,0 +1,181 @@
+// Copyright 2024 Samuel Freeman All rights reserved.
+
+
+#include "Framework/LandscapeHeightfieldStore.h"
+#include "Framework/LandscapeChunkScheduler.h"
+
+
+void FLandscapeHeightfieldStore::Reset(const FVector& InLandscapeOrigin, float InSectionScale)
+{
+    FWriteScopeLock WriteLock(TilesLock);
+    Tiles.Empty();
+    LandscapeOrigin = InLandscapeOrigin;
+    SectionScale = InSectionScale;
+    bHasTileOrigin = false;
+    Generation++;
+}
+
+void FLandscapeHeightfieldStore::Empty()
+{
+    FWriteScopeLock WriteLock(TilesLock);
+    Tiles.Empty();
+    bHasTileOrigin = false;
+    Generation++;
+}
+
+void FLandscapeHeightfieldStore::SetTile(const FIntPoint& InChunk, const FLandscapeHeightfieldTilePtr& InTile, uint32 InGeneration, const FSectionJobToken* InJobToken)
+{
+    if (!InTile || !InTile->IsValid())
+    {
+        return;
+    }
+
+    FWriteScopeLock WriteLock(TilesLock);
+    if (InGeneration != Generation.load() || (InJobToken && InJobToken->IsCancelled()))
+    {
+        return;
+    }
+
+    if (!bHasTileOrigin)
+    {
+        TileOrigin = InTile->Origin;
+        bHasTileOrigin = true;
+    }
+    Tiles.Add(InChunk, InTile);
+}
+
+void FLandscapeHeightfieldStore::RemoveTile(const FIntPoint& InChunk)
+{
+    FWriteScopeLock WriteLock(TilesLock);
+    Tiles.Remove(InChunk);
+}
+
+FLandscapeHeightfieldTilePtr FLandscapeHeightfieldStore::FindTile(const FIntPoint& InChunk) const
+{
+    FReadScopeLock ReadLock(TilesLock);
+    const FLandscapeHeightfieldTilePtr* Tile = Tiles.Find(InChunk);
+    return Tile ? *Tile : nullptr;
+}
+
+bool FLandscapeHeightfieldStore::GetTileOrigin(FVector2f& OutTileOrigin) const
+{
+    FReadScopeLock ReadLock(TilesLock);
+    OutTileOrigin = TileOrigin;
+    return bHasTileOrigin;
+}
+
+int32 FLandscapeHeightfieldStore::Num() const
+{
+    FReadScopeLock ReadLock(TilesLock);
+    return Tiles.Num();
+}
+
+SIZE_T FLandscapeHeightfieldStore::GetAllocatedSize() const
+{
+    FReadScopeLock ReadLock(TilesLock);
+    SIZE_T AllocatedSize = Tiles.GetAllocatedSize();
+    for (const TPair<FIntPoint, FLandscapeHeightfieldTilePtr>& TilePair : Tiles)
+    {
+        AllocatedSize += sizeof(FLandscapeHeightfieldTile) + TilePair.Value->GetAllocatedSize();
+    }
+    return AllocatedSize;
+}
+
+bool FLandscapeHeightfieldStore::SampleHeight(const FVector& InWorldLocation, float& OutHeight) const
+{
+    FReadScopeLock ReadLock(TilesLock);
+
+    FIntPoint Chunk;
+    FVector2f LocalPosition;
+    if (!ToChunkLocal(InWorldLocation, Chunk, LocalPosition))
+    {
+        return false;
+    }
+
+    const FLandscapeHeightfieldTile* Tile = FindTileLocked(Chunk);
+    if (!Tile)
+    {
+        return false;
+    }
+
+    OutHeight = LandscapeOrigin.Z + Tile->SampleHeight(LocalPosition);
+    return true;
+}
+
+bool FLandscapeHeightfieldStore::SampleNormal(const FVector& InWorldLocation, FVector& OutNormal) const
+{
+    FReadScopeLock ReadLock(TilesLock);
+
+    FIntPoint Chunk;
+    FVector2f LocalPosition;
+    if (!ToChunkLocal(InWorldLocation, Chunk, LocalPosition))
+    {
+        return false;
+    }
+
+    const FLandscapeHeightfieldTile* Tile = FindTileLocked(Chunk);
+    if (!Tile)
+    {
+        return false;
+    }
+
+    OutNormal = FVector(Tile->SampleNormal(LocalPosition));
+    return true;
+}
+
+int32 FLandscapeHeightfieldStore::SampleHeights(TConstArrayView<FVector> InWorldLocations, TArray<float>& OutHeights, TArray<bool>& OutValid) const
+{
+    OutHeights.SetNumZeroed(InWorldLocations.Num());
+    OutValid.Init(false, InWorldLocations.Num());
+
+    FReadScopeLock ReadLock(TilesLock);
+
+    int32 NumValid = 0;
+    FIntPoint LastChunk(MAX_int32, MAX_int32);
+    const FLandscapeHeightfieldTile* LastTile = nullptr;
+
+    for (int32 i = 0; i < InWorldLocations.Num(); i++)
+    {
+        FIntPoint Chunk;
+        FVector2f LocalPosition;
+        if (!ToChunkLocal(InWorldLocations[i], Chunk, LocalPosition))
+        {
+            continue;
+        }
+
+        if (Chunk != LastChunk)
+        {
+            LastChunk = Chunk;
+            LastTile = FindTileLocked(Chunk);
+        }
+        if (LastTile)
+        {
+            OutHeights[i] = LandscapeOrigin.Z + LastTile->SampleHeight(LocalPosition);
+            OutValid[i] = true;
+            NumValid++;
+        }
+    }
+    return NumValid;
+}
+
+bool FLandscapeHeightfieldStore::ToChunkLocal(const FVector& InWorldLocation, FIntPoint& OutChunk, FVector2f& OutLocalPosition) const
+{
+    if (!bHasTileOrigin || SectionScale <= 0.0f)
+    {
+        return false;
+    }
+
+    // Section components sit at Chunk * SectionScale from the landscape, Their grid starts at TileOrigin inside the component.
+    double RelativeX = InWorldLocation.X - LandscapeOrigin.X;
+    double RelativeY = InWorldLocation.Y - LandscapeOrigin.Y;
+    OutChunk.X = FMath::FloorToInt32((RelativeX - TileOrigin.X) / SectionScale);
+    OutChunk.Y = FMath::FloorToInt32((RelativeY - TileOrigin.Y) / SectionScale);
+    OutLocalPosition = FVector2f(float(RelativeX - double(OutChunk.X) * SectionScale), float(RelativeY - double(OutChunk.Y) * SectionScale));
+    return true;
+}
+
+const FLandscapeHeightfieldTile* FLandscapeHeightfieldStore::FindTileLocked(const FIntPoint& InChunk) const
+{
+    const FLandscapeHeightfieldTilePtr* Tile = Tiles.Find(InChunk);
+    return Tile ? Tile->Get() : nullptr;
+}
@@ -0,0 +1,67 @@
+// Copyright 2024 Samuel Freeman All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Misc/ScopeRWLock.h"
+#include "Framework/LandscapeHeightfield.h"
+#include <atomic>
+
+class FSectionJobToken;
+
+typedef TSharedPtr<const FLandscapeHeightfieldTile, ESPMode::ThreadSafe> FLandscapeHeightfieldTilePtr;
+
+
+// Heightfields of every resident section, Published by the section jobs and read by height and normal queries.
+// Queries never touch the realtime meshes, so gameplay, AI and foliage code can sample the terrain from any thread
+// while sections are being built. Tiles are immutable once published, a rebuilt section swaps in a new tile.
+class FLandscapeHeightfieldStore
+{
+public:
+
+    // Called on the game thread when the landscape is initialized, Bumps the generation so tiles from older jobs are dropped.
+    void Reset(const FVector& InLandscapeOrigin, float InSectionScale);
+
+    void Empty();
+
+    // Tiles built for an older generation (jobs issued before the last Reset or Empty) are ignored, So are tiles whose job token was cancelled.
+    // Both are checked under the write lock, A section removed after cancelling its job can not have the tile land after RemoveTile.
+    void SetTile(const FIntPoint& InChunk, const FLandscapeHeightfieldTilePtr& InTile, uint32 InGeneration, const FSectionJobToken* InJobToken = nullptr);
+    void RemoveTile(const FIntPoint& InChunk);
+
+    FLandscapeHeightfieldTilePtr FindTile(const FIntPoint& InChunk) const;
+
+    // World space queries, Return false when no resident section covers the location.
+    bool SampleHeight(const FVector& InWorldLocation, float& OutHeight) const;
+    bool SampleNormal(const FVector& InWorldLocation, FVector& OutNormal) const;
+
+    // Samples many locations under a single lock, Neighbouring locations in the batch usually share a tile so it is only looked up once per run.
+    // OutHeights is in world space, OutValid flags the locations that hit a resident section.
+    int32 SampleHeights(TConstArrayView<FVector> InWorldLocations, TArray<float>& OutHeights, TArray<bool>& OutValid) const;
+
+    // Local position of grid vertex (0, 0) inside every section component, Returns false until the first tile is published.
+    bool GetTileOrigin(FVector2f& OutTileOrigin) const;
+
+    uint32 GetGeneration() const { return Generation.load(); }
+    int32 Num() const;
+    SIZE_T GetAllocatedSize() const;
+
+private:
+
+    // Chunk containing the location and the location relative to that chunks section component.
+    bool ToChunkLocal(const FVector& InWorldLocation, FIntPoint& OutChunk, FVector2f& OutLocalPosition) const;
+
+    const FLandscapeHeightfieldTile* FindTileLocked(const FIntPoint& InChunk) const;
+
+    mutable FRWLock TilesLock;
+    TMap<FIntPoint, FLandscapeHeightfieldTilePtr> Tiles;
+
+    FVector LandscapeOrigin = FVector::ZeroVector;
+    float SectionScale = 0.0f;
+
+    // Local position of grid vertex (0, 0), The same for every section so it is taken from the first tile published.
+    FVector2f TileOrigin = FVector2f::ZeroVector;
+    bool bHasTileOrigin = false;
+
+    std::atomic<uint32> Generation = 0;
+};
@@ -0,0 +1,127 @@
+// Copyright 2024 Samuel Freeman All rights reserved.
+
+
+#include "Framework/LandscapeLODRingTable.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+
+
+void FLandscapeLODRingTable::Reset()
+{
+    LODs.Reset();
+    DistanceToLOD.Reset();
+}
+
+void FLandscapeLODRingTable::AddLOD(int32 InLODDistance, int32 InResolution, bool bInSpawnFoliage, ELandscapeCollisionPolicy InCollisionPolicy)
+{
+    FLandscapeLODInfo& LODInfo = LODs.AddDefaulted_GetRef();
+    LODInfo.Resolution = InResolution;
+    LODInfo.bSpawnFoliage = bInSpawnFoliage;
+    LODInfo.CollisionPolicy = InCollisionPolicy;
+    LODInfo.OuterDistance = (LODs.Num() > 1 ? LODs[LODs.Num() - 2].OuterDistance : 0) + FMath::Max(InLODDistance, 0);
+}
+
+void FLandscapeLODRingTable::Build()
+{
+    DistanceToLOD.Reset();
+    if (LODs.IsEmpty())
+    {
+        return;
+    }
+
+    checkf(LODs.Num() <= MAX_uint8 + 1, TEXT("Landscape Lod ring table supports at most %d Lods"), MAX_uint8 + 1);
+
+    DistanceToLOD.SetNumUninitialized(LODs.Last().OuterDistance + 1);
+    int32 LODDepth = 0;
+    for (int32 Distance = 0; Distance < DistanceToLOD.Num(); Distance++)
+    {
+        while (Distance > LODs[LODDepth].OuterDistance)
+        {
+            LODDepth++;
+        }
+        DistanceToLOD[Distance] = uint8(LODDepth);
+    }
+}
+
+
+// Debug and testing
+
+static FAutoConsoleCommand LandscapeLODRingBenchmarkCommand(
+    TEXT("landscape.LOD.BenchmarkRingTable"),
+    TEXT("Times Lod lookups over a large window with the ring table against the old per index TMap cache. Optional args : Radius (default 64), Passes (default 20)."),
+    FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+        {
+            const int32 Radius = Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 64;
+            const int32 Passes = Args.Num() > 1 ? FMath::Max(FCString::Atoi(*Args[1]), 1) : 20;
+
+            // Eight rings covering the radius, Matches the shape of a typical Lod setup.
+            FLandscapeLODRingTable RingTable;
+            TArray<int32> RingDistances;
+            for (int32 i = 0; i < 8; i++)
+            {
+                RingDistances.Add(FMath::Max(Radius / 8, 1));
+                RingTable.AddLOD(RingDistances.Last(), 64 >> FMath::Min(i, 4), i < 2, ELandscapeCollisionPolicy::Complex);
+            }
+            RingTable.Build();
+
+            // The lookup GetLODForIndex used to do, Hash the index pair and loop the Lods on a miss.
+            TMap<TPair<int32, int32>, int32> LODCache;
+            auto LookupCached = [&LODCache, &RingDistances](int32 InXIndex, int32 InYIndex)
+                {
+                    TPair<int32, int32> IndexPair(InXIndex, InYIndex);
+                    if (LODCache.Contains(IndexPair))
+                    {
+                        return LODCache[IndexPair];
+                    }
+
+                    int32 MaxGenerationDistance = FMath::Max(InXIndex, InYIndex);
+                    int32 CumulativeGenerationDistance = 0;
+                    for (int32 i = 0; i < RingDistances.Num(); i++)
+                    {
+                        CumulativeGenerationDistance += RingDistances[i];
+                        if (MaxGenerationDistance <= CumulativeGenerationDistance)
+                        {
+                            LODCache.Add(IndexPair, i);
+                            return i;
+                        }
+                    }
+                    return RingDistances.Num() - 1;
+                };
+
+            int64 CachedChecksum = 0;
+            int64 RingChecksum = 0;
+
+            double StartTime = FPlatformTime::Seconds();
+            for (int32 Pass = 0; Pass < Passes; Pass++)
+            {
+                for (int32 X = -Radius; X <= Radius; X++)
+                {
+                    for (int32 Y = -Radius; Y <= Radius; Y++)
+                    {
+                        CachedChecksum += LookupCached(FMath::Abs(X), FMath::Abs(Y));
+                    }
+                }
+            }
+            double CachedSeconds = FPlatformTime::Seconds() - StartTime;
+
+            StartTime = FPlatformTime::Seconds();
+            for (int32 Pass = 0; Pass < Passes; Pass++)
+            {
+                for (int32 X = -Radius; X <= Radius; X++)
+                {
+                    for (int32 Y = -Radius; Y <= Radius; Y++)
+                    {
+                        RingChecksum += RingTable.GetLODForIndex(X, Y);
+                    }
+                }
+            }
+            double RingSeconds = FPlatformTime::Seconds() - StartTime;
+
+            const double Lookups = double(Passes) * FMath::Square(2.0 * Radius + 1.0);
+            UE_LOG(LogTemp, Display, TEXT("Landscape Lod lookup, radius %d, %.0f lookups : TMap cache %.2f ns/lookup, Ring table %.2f ns/lookup (%.1fx), Results %s"),
+                Radius, Lookups,
+                CachedSeconds * 1e9 / Lookups,
+                RingSeconds * 1e9 / Lookups,
+                RingSeconds > 0.0 ? CachedSeconds / RingSeconds : 0.0,
+                CachedChecksum == RingChecksum ? TEXT("match") : TEXT("DIFFER"));
+        }));
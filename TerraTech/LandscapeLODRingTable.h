@@ -0,0 +1,58 @@
+// Copyright 2024 Samuel Freeman All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Framework/LandscapeSectionCollision.h"
+
+
+struct FLandscapeLODInfo
+{
+    int32 Resolution = 4;
+    bool bSpawnFoliage = false;
+    ELandscapeCollisionPolicy CollisionPolicy = ELandscapeCollisionPolicy::Complex;
+
+    // Largest Chebyshev distance (in chunks) that still uses this Lod.
+    int32 OuterDistance = 0;
+};
+
+// Flat Lod lookup built once from the Lod depths.
+// A sections Lod only depends on its Chebyshev distance max(|X|, |Y|) from the viewer,
+// so the table maps every distance up to the outermost ring straight to its Lod, Anything further out uses the last Lod.
+// The resolution, foliage flag and collision policy of every Lod are stored alongside so spawning a section does not go back to the Lod settings.
+class FLandscapeLODRingTable
+{
+public:
+
+    void Reset();
+
+    // Lods are added innermost first, InLODDistance is the width of the ring in chunks.
+    void AddLOD(int32 InLODDistance, int32 InResolution, bool bInSpawnFoliage, ELandscapeCollisionPolicy InCollisionPolicy);
+
+    // Fills the distance lookup, Call once every Lod has been added.
+    void Build();
+
+    int32 GetLODForDistance(int32 InDistance) const
+    {
+        return InDistance < DistanceToLOD.Num() ? int32(DistanceToLOD[InDistance]) : LODs.Num() - 1;
+    }
+
+    int32 GetLODForIndex(int32 InXIndex, int32 InYIndex) const
+    {
+        return GetLODForDistance(FMath::Max(FMath::Abs(InXIndex), FMath::Abs(InYIndex)));
+    }
+
+    int32 GetResolution(int32 InLODDepth) const { return LODs[InLODDepth].Resolution; }
+    bool ShouldSpawnFoliage(int32 InLODDepth) const { return LODs[InLODDepth].bSpawnFoliage; }
+    ELandscapeCollisionPolicy GetCollisionPolicy(int32 InLODDepth) const { return LODs[InLODDepth].CollisionPolicy; }
+    int32 GetOuterDistance(int32 InLODDepth) const { return LODs[InLODDepth].OuterDistance; }
+
+    int32 Num() const { return LODs.Num(); }
+    bool IsEmpty() const { return LODs.IsEmpty(); }
+    bool IsValidLOD(int32 InLODDepth) const { return LODs.IsValidIndex(InLODDepth); }
+
+private:
+
+    TArray<FLandscapeLODInfo> LODs;
+    TArray<uint8> DistanceToLOD;
+};
@@ -0,0 +1,25 @@
+// Copyright 2024 Samuel Freeman All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+
+// What an edit to the generation params touched, Decides how much of the landscape OnConstruction has to rebuild.
+enum class ELandscapeParamChange : uint8
+{
+    None = 0,
+
+    // Only the terrain material, Sections keep their meshes and are re-bound.
+    Material = 1 << 0,
+
+    // Lod ring distances, foliage or collision per ring, or the generation distance, Only sections whose depth changed are rebuilt.
+    LOD = 1 << 1,
+
+    // Noise, world offsets, UV scale or section resolutions, Every section is rebuilt in place on the component it already has.
+    Geometry = 1 << 2,
+
+    // Section scale, Every chunk moves so the landscape is cleaned up and generated again.
+    Layout = 1 << 3
+};
+ENUM_CLASS_FLAGS(ELandscapeParamChange);
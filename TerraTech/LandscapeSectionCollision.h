@@ -0,0 +1,21 @@
+// Copyright 2024 Samuel Freeman All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "LandscapeSectionCollision.generated.h"
+
+
+// Collision a section gets at a Lod depth, Only cooked while a physics relevant actor is within the collision activation radius.
+UENUM(BlueprintType)
+enum class ELandscapeCollisionPolicy : uint8
+{
+    // No collision at this Lod depth.
+    None,
+
+    // An invisible low resolution grid resampled from the sections heightfield.
+    Simplified,
+
+    // The rendered section itself, cooked complex as simple.
+    Complex
+};
@@ -0,0 +1,43 @@
+// Copyright 2024 Samuel Freeman All rights reserved.
+
+
+#include "Framework/LandscapeSectionTopology.h"
+
+
+FLandscapeSectionTopology::FLandscapeSectionTopology(int32 InLODResolution, float InUVScale)
+    : LODResolution(FMath::Max(InLODResolution, 1))
+    , UVScale(InUVScale)
+    , VerticesPerSide(LODResolution + 1)
+{
+    const int32 NumVertices = GetNumVertices();
+    UVs.Reserve(NumVertices);
+    Tangents.Init(FVector3f(1.0f, 0.0f, 0.0f), NumVertices);
+    Triangles.Reserve(LODResolution * LODResolution * 6);
+
+    for (int32 X = 0; X < VerticesPerSide; X++)
+    {
+        for (int32 Y = 0; Y < VerticesPerSide; Y++)
+        {
+            UVs.Add(FVector2f(float(X) / LODResolution * UVScale, float(Y) / LODResolution * UVScale));
+        }
+    }
+
+    for (int32 X = 0; X < LODResolution; X++)
+    {
+        for (int32 Y = 0; Y < LODResolution; Y++)
+        {
+            uint32 Vert0 = GetVertexIndex(X, Y);
+            uint32 Vert1 = GetVertexIndex(X + 1, Y);
+            uint32 Vert2 = GetVertexIndex(X + 1, Y + 1);
+            uint32 Vert3 = GetVertexIndex(X, Y + 1);
+
+            Triangles.Add(Vert0);
+            Triangles.Add(Vert1);
+            Triangles.Add(Vert3);
+
+            Triangles.Add(Vert1);
+            Triangles.Add(Vert2);
+            Triangles.Add(Vert3);
+        }
+    }
+}
@@ -0,0 +1,62 @@
+// Copyright 2024 Samuel Freeman All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+
+// Immutable grid triangulation shared by every section built at the same Lod resolution and UV scale.
+// Vertices are laid out X major, the vertex at grid (X, Y) is X * VerticesPerSide + Y, matching the engines welded grid helpers.
+// Section jobs only write positions and normals, indices, UVs and the flat tangent basis are read from here.
+struct FLandscapeSectionTopology
+{
+    int32 LODResolution = 0;
+    float UVScale = 1.0f;
+    int32 VerticesPerSide = 0;
+
+    TArray<uint32> Triangles;
+    TArray<FVector2f> UVs;
+
+    // Terrain tangents are taken along the grid X axis, The shading normal carries the slope.
+    TArray<FVector3f> Tangents;
+
+    FLandscapeSectionTopology(int32 InLODResolution, float InUVScale);
+
+    int32 GetNumVertices() const { return VerticesPerSide * VerticesPerSide; }
+    int32 GetVertexIndex(int32 InX, int32 InY) const { return InX * VerticesPerSide + InY; }
+
+    SIZE_T GetAllocatedSize() const { return Triangles.GetAllocatedSize() + UVs.GetAllocatedSize() + Tangents.GetAllocatedSize(); }
+};
+
+typedef TSharedPtr<const FLandscapeSectionTopology, ESPMode::ThreadSafe> FLandscapeSectionTopologyPtr;
+
+// Edges of a built section, in the order West (-X), East (+X), South (-Y), North (+Y), Opposite edges differ only in the lowest bit.
+enum class ESectionEdge : uint8
+{
+    West,
+    East,
+    South,
+    North,
+    Count
+};
+
+struct FSectionEdge
+{
+    // Vertices along the edge sorted by their position along it, with the heights and normals they were generated with.
+    // GeneratedNormals is empty when the section has no tangent stream.
+    TArray<int32> VertexIndices;
+    TArray<float> GeneratedHeights;
+    TArray<FVector3f> GeneratedNormals;
+
+    // Resolution the edge currently matches, Equal to the sections own resolution while the edge is unstitched.
+    int32 StitchedResolution = 0;
+};
+
+// Per section record used to stitch edges against neighbours generated at a coarser Lod resolution.
+struct FSectionEdgeState
+{
+    int32 Resolution = 0;
+    FSectionEdge Edges[int32(ESectionEdge::Count)];
+
+    bool IsCaptured() const { return Resolution > 0; }
+};
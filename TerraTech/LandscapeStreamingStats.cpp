@@ -0,0 +1,174 @@
+// Copyright 2024 Samuel Freeman All rights reserved.
+
+
+#include "Framework/LandscapeStreamingStats.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/FileHelper.h"
+
+
+DEFINE_STAT(STAT_LandscapeSectionBuild);
+DEFINE_STAT(STAT_LandscapeSectionGenerate);
+DEFINE_STAT(STAT_LandscapeBiomeBlend);
+DEFINE_STAT(STAT_LandscapeNormals);
+DEFINE_STAT(STAT_LandscapeStreamBuild);
+DEFINE_STAT(STAT_LandscapeSectionReadback);
+DEFINE_STAT(STAT_LandscapeCacheLoad);
+DEFINE_STAT(STAT_LandscapeCacheSave);
+DEFINE_STAT(STAT_LandscapeFoliagePlacement);
+DEFINE_STAT(STAT_LandscapeApplyEdits);
+
+DEFINE_STAT(STAT_LandscapeUpdateStreaming);
+DEFINE_STAT(STAT_LandscapeRemoveSections);
+DEFINE_STAT(STAT_LandscapeDispatch);
+DEFINE_STAT(STAT_LandscapeCommit);
+DEFINE_STAT(STAT_LandscapeCollision);
+DEFINE_STAT(STAT_LandscapeFoliageSpawn);
+DEFINE_STAT(STAT_LandscapeTerrainEdit);
+
+DEFINE_STAT(STAT_LandscapeJobsInFlight);
+DEFINE_STAT(STAT_LandscapePendingJobs);
+DEFINE_STAT(STAT_LandscapeCommitQueueDepth);
+DEFINE_STAT(STAT_LandscapeResidentTiles);
+
+CSV_DEFINE_CATEGORY(LandscapeStreaming, true);
+
+
+void FLandscapeStreamingTelemetry::Reset()
+{
+    Timings.Reset();
+    NextTiming = 0;
+    SectionsCommitted = 0;
+    JobsCancelled = 0;
+    JobsInFlight = 0;
+    PendingJobs = 0;
+    CommitQueueDepth = 0;
+    ResidentTiles = 0;
+}
+
+void FLandscapeStreamingTelemetry::RecordCommit(const FLandscapeChunkTiming& InTiming)
+{
+    SectionsCommitted++;
+
+    if (Timings.Num() < MaxTimings)
+    {
+        Timings.Add(InTiming);
+    }
+    else
+    {
+        Timings[NextTiming] = InTiming;
+    }
+    NextTiming = (NextTiming + 1) % MaxTimings;
+
+    CSV_CUSTOM_STAT(LandscapeStreaming, TimeToVisibleMs, InTiming.TimeToVisibleMilliseconds, ECsvCustomStatOp::Max);
+}
+
+void FLandscapeStreamingTelemetry::UpdateGauges(int32 InJobsInFlight, int32 InPendingJobs, int32 InCommitQueueDepth, int32 InResidentTiles)
+{
+    JobsInFlight = InJobsInFlight;
+    PendingJobs = InPendingJobs;
+    CommitQueueDepth = InCommitQueueDepth;
+    ResidentTiles = InResidentTiles;
+
+    SET_DWORD_STAT(STAT_LandscapeJobsInFlight, JobsInFlight);
+    SET_DWORD_STAT(STAT_LandscapePendingJobs, PendingJobs);
+    SET_DWORD_STAT(STAT_LandscapeCommitQueueDepth, CommitQueueDepth);
+    SET_DWORD_STAT(STAT_LandscapeResidentTiles, ResidentTiles);
+
+    CSV_CUSTOM_STAT(LandscapeStreaming, JobsInFlight, JobsInFlight, ECsvCustomStatOp::Set);
+    CSV_CUSTOM_STAT(LandscapeStreaming, PendingJobs, PendingJobs, ECsvCustomStatOp::Set);
+    CSV_CUSTOM_STAT(LandscapeStreaming, CommitQueueDepth, CommitQueueDepth, ECsvCustomStatOp::Set);
+    CSV_CUSTOM_STAT(LandscapeStreaming, ResidentTiles, ResidentTiles, ECsvCustomStatOp::Set);
+}
+
+FLandscapeStreamingSummary FLandscapeStreamingTelemetry::GetSummary() const
+{
+    FLandscapeStreamingSummary Summary;
+    Summary.SectionsCommitted = SectionsCommitted;
+    Summary.JobsCancelled = JobsCancelled;
+    Summary.JobsInFlight = JobsInFlight;
+    Summary.PendingJobs = PendingJobs;
+    Summary.CommitQueueDepth = CommitQueueDepth;
+    Summary.ResidentTiles = ResidentTiles;
+
+    TArray<float> QueueSamples;
+    TArray<float> BuildSamples;
+    TArray<float> VisibleSamples;
+    QueueSamples.Reserve(Timings.Num());
+    BuildSamples.Reserve(Timings.Num());
+
+    double WindowStart = FPlatformTime::Seconds() - RateWindowSeconds;
+    int32 CommitsInWindow = 0;
+
+    ForEachTiming([&](const FLandscapeChunkTiming& Timing)
+        {
+            QueueSamples.Add(Timing.QueueMilliseconds);
+            BuildSamples.Add(Timing.BuildMilliseconds);
+            if (!Timing.bIsUpdate)
+            {
+                VisibleSamples.Add(Timing.TimeToVisibleMilliseconds);
+            }
+            if (Timing.CommitTime >= WindowStart)
+            {
+                CommitsInWindow++;
+            }
+        });
+
+    Summary.ChunksPerSecond = float(CommitsInWindow / RateWindowSeconds);
+    Summary.QueueP50 = GetPercentile(QueueSamples, 0.5f);
+    Summary.QueueP99 = GetPercentile(QueueSamples, 0.99f);
+    Summary.BuildP50 = GetPercentile(BuildSamples, 0.5f);
+    Summary.BuildP99 = GetPercentile(BuildSamples, 0.99f);
+    Summary.TimeToVisibleP50 = GetPercentile(VisibleSamples, 0.5f);
+    Summary.TimeToVisibleP99 = GetPercentile(VisibleSamples, 0.99f);
+    return Summary;
+}
+
+void FLandscapeStreamingTelemetry::LogSummary(const FString& InLandscapeName) const
+{
+    FLandscapeStreamingSummary Summary = GetSummary();
+
+    UE_LOG(LogTemp, Display, TEXT("Landscape Streaming [%s] : Committed %lld, Cancelled %lld, %.1f chunks/s, In flight %d, Pending %d, Commit queue %d, Resident heightfields %d"),
+        *InLandscapeName, Summary.SectionsCommitted, Summary.JobsCancelled, Summary.ChunksPerSecond,
+        Summary.JobsInFlight, Summary.PendingJobs, Summary.CommitQueueDepth, Summary.ResidentTiles);
+    UE_LOG(LogTemp, Display, TEXT("Landscape Streaming [%s] : Queue p50 %.2f ms p99 %.2f ms, Build p50 %.2f ms p99 %.2f ms, Time to visible p50 %.2f ms p99 %.2f ms"),
+        *InLandscapeName, Summary.QueueP50, Summary.QueueP99, Summary.BuildP50, Summary.BuildP99, Summary.TimeToVisibleP50, Summary.TimeToVisibleP99);
+}
+
+bool FLandscapeStreamingTelemetry::ExportCSV(const FString& InFilePath) const
+{
+    TArray<FString> Lines;
+    Lines.Reserve(Timings.Num() + 1);
+    Lines.Add(TEXT("CommitTime,ChunkX,ChunkY,LODDepth,IsUpdate,QueueMs,BuildMs,TimeToVisibleMs"));
+
+    ForEachTiming([&Lines](const FLandscapeChunkTiming& Timing)
+        {
+            Lines.Add(FString::Printf(TEXT("%.4f,%d,%d,%d,%d,%.3f,%.3f,%.3f"),
+                Timing.CommitTime, Timing.Chunk.X, Timing.Chunk.Y, Timing.LODDepth, Timing.bIsUpdate ? 1 : 0,
+                Timing.QueueMilliseconds, Timing.BuildMilliseconds, Timing.TimeToVisibleMilliseconds));
+        });
+
+    return FFileHelper::SaveStringArrayToFile(Lines, *InFilePath);
+}
+
+template<typename FuncType>
+void FLandscapeStreamingTelemetry::ForEachTiming(FuncType&& InFunc) const
+{
+    // Once the ring is full NextTiming points at the oldest entry.
+    int32 FirstTiming = Timings.Num() < MaxTimings ? 0 : NextTiming;
+    for (int32 i = 0; i < Timings.Num(); i++)
+    {
+        InFunc(Timings[(FirstTiming + i) % Timings.Num()]);
+    }
+}
+
+float FLandscapeStreamingTelemetry::GetPercentile(TArray<float>& InSamples, float InPercentile)
+{
+    if (InSamples.IsEmpty())
+    {
+        return 0.0f;
+    }
+
+    InSamples.Sort();
+    int32 SampleIndex = FMath::Clamp(FMath::CeilToInt32(InPercentile * InSamples.Num()) - 1, 0, InSamples.Num() - 1);
+    return InSamples[SampleIndex];
+}
@@ -0,0 +1,125 @@
+// Copyright 2024 Samuel Freeman All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+
+
+DECLARE_STATS_GROUP(TEXT("Landscape Streaming"), STATGROUP_LandscapeStreaming, STATCAT_Advanced);
+
+// Section job phases, Run on the worker threads.
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Section Build"), STAT_LandscapeSectionBuild, STATGROUP_LandscapeStreaming, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Section Generate"), STAT_LandscapeSectionGenerate, STATGROUP_LandscapeStreaming, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Biome Blend"), STAT_LandscapeBiomeBlend, STATGROUP_LandscapeStreaming, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Normals"), STAT_LandscapeNormals, STATGROUP_LandscapeStreaming, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Stream Build"), STAT_LandscapeStreamBuild, STATGROUP_LandscapeStreaming, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Section Readback"), STAT_LandscapeSectionReadback, STATGROUP_LandscapeStreaming, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Chunk Cache Load"), STAT_LandscapeCacheLoad, STATGROUP_LandscapeStreaming, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Chunk Cache Save"), STAT_LandscapeCacheSave, STATGROUP_LandscapeStreaming, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Foliage Placement"), STAT_LandscapeFoliagePlacement, STATGROUP_LandscapeStreaming, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Apply Edits"), STAT_LandscapeApplyEdits, STATGROUP_LandscapeStreaming, );
+
+// Game thread phases.
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Update Streaming"), STAT_LandscapeUpdateStreaming, STATGROUP_LandscapeStreaming, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Remove Sections"), STAT_LandscapeRemoveSections, STATGROUP_LandscapeStreaming, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Dispatch Sections"), STAT_LandscapeDispatch, STATGROUP_LandscapeStreaming, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Commit Sections"), STAT_LandscapeCommit, STATGROUP_LandscapeStreaming, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Collision"), STAT_LandscapeCollision, STATGROUP_LandscapeStreaming, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Foliage Spawn"), STAT_LandscapeFoliageSpawn, STATGROUP_LandscapeStreaming, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Terrain Edit"), STAT_LandscapeTerrainEdit, STATGROUP_LandscapeStreaming, );
+
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Jobs In Flight"), STAT_LandscapeJobsInFlight, STATGROUP_LandscapeStreaming, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Pending Jobs"), STAT_LandscapePendingJobs, STATGROUP_LandscapeStreaming, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Commit Queue Depth"), STAT_LandscapeCommitQueueDepth, STATGROUP_LandscapeStreaming, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Resident Heightfields"), STAT_LandscapeResidentTiles, STATGROUP_LandscapeStreaming, );
+
+CSV_DECLARE_CATEGORY_EXTERN(LandscapeStreaming);
+
+// Named trace event and stat scope for one landscape phase, Shows up in Unreal Insights and under stat LandscapeStreaming.
+#define LANDSCAPE_SCOPE(StatName) \
+    TRACE_CPUPROFILER_EVENT_SCOPE(StatName); \
+    SCOPE_CYCLE_COUNTER(StatName)
+
+
+// Timings of one section job, from the chunk being requested to the section being committed.
+struct FLandscapeChunkTiming
+{
+    FIntPoint Chunk = FIntPoint::ZeroValue;
+    int32 LODDepth = 0;
+    bool bIsUpdate = false;
+
+    // FPlatformTime::Seconds when the section was committed.
+    double CommitTime = 0.0;
+
+    float QueueMilliseconds = 0.0f;
+    float BuildMilliseconds = 0.0f;
+    float TimeToVisibleMilliseconds = 0.0f;
+};
+
+struct FLandscapeStreamingSummary
+{
+    int64 SectionsCommitted = 0;
+    int64 JobsCancelled = 0;
+    float ChunksPerSecond = 0.0f;
+
+    float QueueP50 = 0.0f;
+    float QueueP99 = 0.0f;
+    float BuildP50 = 0.0f;
+    float BuildP99 = 0.0f;
+
+    // Spawns only, An update replaces a section that was already visible.
+    float TimeToVisibleP50 = 0.0f;
+    float TimeToVisibleP99 = 0.0f;
+
+    int32 JobsInFlight = 0;
+    int32 PendingJobs = 0;
+    int32 CommitQueueDepth = 0;
+    int32 ResidentTiles = 0;
+};
+
+// Streaming counters of one landscape, Fed from the game thread as jobs are dispatched and committed.
+// The last MaxTimings jobs are kept for percentiles and the CSV export, Older jobs only count towards the totals.
+class FLandscapeStreamingTelemetry
+{
+public:
+
+    static constexpr int32 MaxTimings = 4096;
+
+    // Chunks per second are averaged over this many seconds.
+    static constexpr double RateWindowSeconds = 5.0;
+
+    void Reset();
+
+    void RecordCommit(const FLandscapeChunkTiming& InTiming);
+    void RecordCancelled() { JobsCancelled++; }
+
+    // Called once a frame, Also publishes the gauges to the stat group and the CSV profiler.
+    void UpdateGauges(int32 InJobsInFlight, int32 InPendingJobs, int32 InCommitQueueDepth, int32 InResidentTiles);
+
+    FLandscapeStreamingSummary GetSummary() const;
+    void LogSummary(const FString& InLandscapeName) const;
+
+    // Writes one row per kept job, Oldest first.
+    bool ExportCSV(const FString& InFilePath) const;
+
+private:
+
+    template<typename FuncType>
+    void ForEachTiming(FuncType&& InFunc) const;
+
+    static float GetPercentile(TArray<float>& InSamples, float InPercentile);
+
+    TArray<FLandscapeChunkTiming> Timings;
+    int32 NextTiming = 0;
+
+    int64 SectionsCommitted = 0;
+    int64 JobsCancelled = 0;
+
+    int32 JobsInFlight = 0;
+    int32 PendingJobs = 0;
+    int32 CommitQueueDepth = 0;
+    int32 ResidentTiles = 0;
+};